@@ -0,0 +1,407 @@
+
+/**
+ * 排序与已排序区间上的算法
+ * sort() 为 introsort：quick sort 递归过深时改用 heap sort，最后以 insertion sort 收尾
+ * __merge_sort_with_buffer() 为稳定排序，由调用端提供暂存空间
+ * lower_bound() / upper_bound() 对 Random Access Iterator 采用无分支的二分搜寻
+ *
+ * 未指定 Compare 的版本一律以 less<value_type> 比较
+ */
+#ifndef TINYSTL_ALGO_H_
+#define TINYSTL_ALGO_H_
+
+#include "heap.h"
+#include "iterator.h"
+#include "algobase.h"
+#include "function.h"
+
+namespace tinystl
+{
+
+/**
+ * sort(first, last)
+ */
+enum { __stl_threshold = 16 }; // 小于此长度的区间留给 insertion sort
+
+// 2^k <= n 的最大 k，用于限制递归深度
+template <class Size>
+  inline Size __lg(Size n)
+  {
+    Size k;
+    for (k = 0; n > 1; n >>= 1) ++k;
+    return k;
+  }
+
+template <class T, class Compare>
+  inline const T& __median(const T& a, const T& b, const T& c, Compare comp)
+  {
+    if (comp(a, b)) {
+      if (comp(b, c)) return b;
+      else if (comp(a, c)) return c;
+      else return a;
+    } else if (comp(a, c)) return a;
+    else if (comp(b, c)) return c;
+    else return b;
+  }
+
+// 以 pivot 分割，不检查边界：两端必定各有一个元素可以停住扫描
+template <class RandomAccessIterator, class T, class Compare>
+  RandomAccessIterator __unguarded_partition(RandomAccessIterator first, RandomAccessIterator last,
+                                             T pivot, Compare comp)
+  {
+    while (true) {
+      while (comp(*first, pivot)) ++first;
+      --last;
+      while (comp(pivot, *last)) --last;
+      if (!(first < last)) return first;
+      tinystl::iter_swap(first, last);
+      ++first;
+    }
+  }
+
+template <class RandomAccessIterator, class T, class Compare>
+  void __unguarded_linear_insert(RandomAccessIterator last, T value, Compare comp)
+  {
+    RandomAccessIterator next = last;
+    --next;
+    while (comp(value, *next)) {
+      *last = *next;
+      last = next;
+      --next;
+    }
+    *last = value;
+  }
+
+template <class RandomAccessIterator, class T, class Compare>
+  inline void __linear_insert(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp)
+  {
+    T value = *last;
+    if (comp(value, *first)) { // 比最小的还小，整段后移
+      tinystl::copy_backward(first, last, last + 1);
+      *first = value;
+    } else
+      tinystl::__unguarded_linear_insert(last, value, comp);
+  }
+
+template <class RandomAccessIterator, class Compare>
+  void __insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    if (first == last) return;
+    for (RandomAccessIterator i = first + 1; i != last; ++i)
+      tinystl::__linear_insert(first, i, value_type(first), comp);
+  }
+
+template <class RandomAccessIterator, class T, class Compare>
+  void __unguarded_insertion_sort_aux(RandomAccessIterator first, RandomAccessIterator last,
+                                      T*, Compare comp)
+  {
+    for (RandomAccessIterator i = first; i != last; ++i)
+      tinystl::__unguarded_linear_insert(i, T(*i), comp);
+  }
+
+// 前 __stl_threshold 个元素中必有整体最小值，其后的元素插入时不必检查边界
+template <class RandomAccessIterator, class Compare>
+  void __final_insertion_sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    if (last - first > __stl_threshold) {
+      tinystl::__insertion_sort(first, first + __stl_threshold, comp);
+      tinystl::__unguarded_insertion_sort_aux(first + __stl_threshold, last, value_type(first), comp);
+    } else
+      tinystl::__insertion_sort(first, last, comp);
+  }
+
+template <class RandomAccessIterator, class T, class Size, class Compare>
+  void __introsort_loop(RandomAccessIterator first, RandomAccessIterator last, T*,
+                        Size depth_limit, Compare comp)
+  {
+    while (last - first > __stl_threshold) {
+      if (depth_limit == 0) { // 分割恶化，改用 heap sort
+        tinystl::make_heap(first, last, comp);
+        tinystl::sort_heap(first, last, comp);
+        return;
+      }
+      --depth_limit;
+      RandomAccessIterator cut = tinystl::__unguarded_partition(
+          first, last, T(tinystl::__median(*first, *(first + (last - first) / 2), *(last - 1), comp)), comp);
+      // 递归右段，左段以循环处理
+      tinystl::__introsort_loop(cut, last, value_type(first), depth_limit, comp);
+      last = cut;
+    }
+  }
+
+template <class RandomAccessIterator, class Compare>
+  inline void sort(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+  {
+    if (first != last) {
+      tinystl::__introsort_loop(first, last, value_type(first), tinystl::__lg(last - first) * 2, comp);
+      tinystl::__final_insertion_sort(first, last, comp);
+    }
+  }
+template <class RandomAccessIterator>
+  inline void sort(RandomAccessIterator first, RandomAccessIterator last)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+    tinystl::sort(first, last, less<T>());
+  }
+
+
+/**
+ * lower_bound(first, last, value) / upper_bound(first, last, value)
+ * 已排序区间中第一个不小于 / 大于 value 的位置
+ * Random Access Iterator 版本每轮只有一次比较与一个条件搬移(cmov)，
+ * 不依赖分支预测，搜寻次数固定为 ceil(log2(n)) + 1
+ */
+template <class ForwardIterator, class T, class Compare>
+  ForwardIterator __lower_bound(ForwardIterator first, ForwardIterator last, const T& value,
+                                Compare comp, forward_iterator_tag)
+  {
+    typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+    Distance len = tinystl::distance(first, last);
+    while (len > 0) {
+      Distance half = len >> 1;
+      ForwardIterator middle = first;
+      tinystl::advance(middle, half);
+      if (comp(*middle, value)) {
+        first = middle;
+        ++first;
+        len = len - half - 1;
+      } else
+        len = half;
+    }
+    return first;
+  }
+template <class RandomAccessIterator, class T, class Compare>
+  RandomAccessIterator __lower_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value,
+                                     Compare comp, random_access_iterator_tag)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance len = last - first;
+    if (len == 0) return first;
+    while (len > 1) {
+      const Distance half = len >> 1;
+      first += comp(first[half], value) ? half : 0;
+      len -= half;
+    }
+    return first + comp(*first, value);
+  }
+template <class ForwardIterator, class T, class Compare>
+  inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value,
+                                     Compare comp)
+  {
+    return tinystl::__lower_bound(first, last, value, comp, iterator_category(first));
+  }
+template <class ForwardIterator, class T>
+  inline ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last, const T& value)
+  {
+    return tinystl::__lower_bound(first, last, value, less<T>(), iterator_category(first));
+  }
+
+template <class ForwardIterator, class T, class Compare>
+  ForwardIterator __upper_bound(ForwardIterator first, ForwardIterator last, const T& value,
+                                Compare comp, forward_iterator_tag)
+  {
+    typedef typename iterator_traits<ForwardIterator>::difference_type Distance;
+    Distance len = tinystl::distance(first, last);
+    while (len > 0) {
+      Distance half = len >> 1;
+      ForwardIterator middle = first;
+      tinystl::advance(middle, half);
+      if (comp(value, *middle))
+        len = half;
+      else {
+        first = middle;
+        ++first;
+        len = len - half - 1;
+      }
+    }
+    return first;
+  }
+template <class RandomAccessIterator, class T, class Compare>
+  RandomAccessIterator __upper_bound(RandomAccessIterator first, RandomAccessIterator last, const T& value,
+                                     Compare comp, random_access_iterator_tag)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance len = last - first;
+    if (len == 0) return first;
+    while (len > 1) {
+      const Distance half = len >> 1;
+      first += comp(value, first[half]) ? 0 : half;
+      len -= half;
+    }
+    return first + !comp(value, *first);
+  }
+template <class ForwardIterator, class T, class Compare>
+  inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last, const T& value,
+                                     Compare comp)
+  {
+    return tinystl::__upper_bound(first, last, value, comp, iterator_category(first));
+  }
+template <class ForwardIterator, class T>
+  inline ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last, const T& value)
+  {
+    return tinystl::__upper_bound(first, last, value, less<T>(), iterator_category(first));
+  }
+
+template <class ForwardIterator, class T, class Compare>
+  inline bool binary_search(ForwardIterator first, ForwardIterator last, const T& value, Compare comp)
+  {
+    ForwardIterator i = tinystl::lower_bound(first, last, value, comp);
+    return i != last && !comp(value, *i);
+  }
+template <class ForwardIterator, class T>
+  inline bool binary_search(ForwardIterator first, ForwardIterator last, const T& value)
+  {
+    return tinystl::binary_search(first, last, value, less<T>());
+  }
+
+
+/**
+ * adjacent_find(first, last) / unique(first, last)
+ * unique() 移除相邻的重复元素，每组保留第一个，传回新区间的尾
+ */
+template <class ForwardIterator, class BinaryPredicate>
+  ForwardIterator adjacent_find(ForwardIterator first, ForwardIterator last, BinaryPredicate pred)
+  {
+    if (first == last) return last;
+    ForwardIterator next = first;
+    while (++next != last) {
+      if (pred(*first, *next)) return first;
+      first = next;
+    }
+    return last;
+  }
+template <class ForwardIterator>
+  inline ForwardIterator adjacent_find(ForwardIterator first, ForwardIterator last)
+  {
+    typedef typename iterator_traits<ForwardIterator>::value_type T;
+    return tinystl::adjacent_find(first, last, equal_to<T>());
+  }
+
+template <class ForwardIterator, class BinaryPredicate>
+  ForwardIterator unique(ForwardIterator first, ForwardIterator last, BinaryPredicate pred)
+  {
+    first = tinystl::adjacent_find(first, last, pred);
+    if (first == last) return last;
+    ForwardIterator dest = first;
+    ++first;
+    while (++first != last)
+      if (!pred(*dest, *first)) *++dest = *first;
+    return ++dest;
+  }
+template <class ForwardIterator>
+  inline ForwardIterator unique(ForwardIterator first, ForwardIterator last)
+  {
+    typedef typename iterator_traits<ForwardIterator>::value_type T;
+    return tinystl::unique(first, last, equal_to<T>());
+  }
+
+
+/**
+ * merge(first1, last1, first2, last2, result)
+ * 合并两个已排序区间，相等的元素中来自第一区间者在前(稳定)
+ */
+template <class InputIterator1, class InputIterator2, class OutputIterator, class Compare>
+  OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                       InputIterator2 first2, InputIterator2 last2,
+                       OutputIterator result, Compare comp)
+  {
+    while (first1 != last1 && first2 != last2) {
+      if (comp(*first2, *first1)) {
+        *result = *first2;
+        ++first2;
+      } else {
+        *result = *first1;
+        ++first1;
+      }
+      ++result;
+    }
+    return tinystl::copy(first2, last2, tinystl::copy(first1, last1, result));
+  }
+template <class InputIterator1, class InputIterator2, class OutputIterator>
+  inline OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                              InputIterator2 first2, InputIterator2 last2,
+                              OutputIterator result)
+  {
+    typedef typename iterator_traits<InputIterator1>::value_type T;
+    return tinystl::merge(first1, last1, first2, last2, result, less<T>());
+  }
+
+// 由尾端开始合并，result 为目的区间的尾
+// 目的区间可以与第一区间的尾端重叠，用于原地合并
+template <class BidirectionalIterator1, class BidirectionalIterator2, class BidirectionalIterator3,
+          class Compare>
+  BidirectionalIterator3 __merge_backward(BidirectionalIterator1 first1, BidirectionalIterator1 last1,
+                                          BidirectionalIterator2 first2, BidirectionalIterator2 last2,
+                                          BidirectionalIterator3 result, Compare comp)
+  {
+    if (first1 == last1) return tinystl::copy_backward(first2, last2, result);
+    if (first2 == last2) return tinystl::copy_backward(first1, last1, result);
+    --last1;
+    --last2;
+    while (true) {
+      if (comp(*last2, *last1)) {
+        *--result = *last1;
+        if (first1 == last1) return tinystl::copy_backward(first2, ++last2, result);
+        --last1;
+      } else {
+        *--result = *last2;
+        if (first2 == last2) return tinystl::copy_backward(first1, ++last1, result);
+        --last2;
+      }
+    }
+  }
+
+
+/**
+ * __merge_sort_with_buffer(first, last, buffer, comp)
+ * 稳定排序：等价的元素维持原本的先后
+ * 先以 insertion sort 排好每 __stl_chunk_size 个元素，再于 [first, last) 与 buffer 之间来回合并
+ * buffer 至少要有 last - first 个已构造的元素
+ */
+enum { __stl_chunk_size = 7 };
+
+template <class RandomAccessIterator, class Distance, class Compare>
+  void __chunk_insertion_sort(RandomAccessIterator first, RandomAccessIterator last,
+                              Distance chunk_size, Compare comp)
+  {
+    while (last - first >= chunk_size) {
+      tinystl::__insertion_sort(first, first + chunk_size, comp);
+      first += chunk_size;
+    }
+    tinystl::__insertion_sort(first, last, comp);
+  }
+
+// 将长度为 step_size 的相邻两段合并至 result
+template <class RandomAccessIterator1, class RandomAccessIterator2, class Distance, class Compare>
+  void __merge_sort_loop(RandomAccessIterator1 first, RandomAccessIterator1 last,
+                         RandomAccessIterator2 result, Distance step_size, Compare comp)
+  {
+    Distance two_step = 2 * step_size;
+    while (last - first >= two_step) {
+      result = tinystl::merge(first, first + step_size, first + step_size, first + two_step, result, comp);
+      first += two_step;
+    }
+    step_size = tinystl::min(Distance(last - first), step_size);
+    tinystl::merge(first, first + step_size, first + step_size, last, result, comp);
+  }
+
+template <class RandomAccessIterator, class RandomAccessIterator2, class Compare>
+  void __merge_sort_with_buffer(RandomAccessIterator first, RandomAccessIterator last,
+                                RandomAccessIterator2 buffer, Compare comp)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    Distance len = last - first;
+    RandomAccessIterator2 buffer_last = buffer + len;
+    Distance step_size = __stl_chunk_size;
+    tinystl::__chunk_insertion_sort(first, last, step_size, comp);
+    while (step_size < len) { // 每一轮来回各一次，结果回到 [first, last)
+      tinystl::__merge_sort_loop(first, last, buffer, step_size, comp);
+      step_size *= 2;
+      tinystl::__merge_sort_loop(buffer, buffer_last, first, step_size, comp);
+      step_size *= 2;
+    }
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ALGO_H_
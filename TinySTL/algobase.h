@@ -1,10 +1,212 @@
+
 #ifndef TINYSTL_ALGOBASE_H_
 #define TINYSTL_ALGOBASE_H_
 
+#include <string.h> // for memmove() memset()
+#include "iterator.h"
+#include "type_traits.h"
+
 namespace tinystl
 {
 
+/**
+ * min() / max()
+ * 相等时传回第一参数
+ */
+template <class T>
+  inline const T& min(const T& a, const T& b)
+  {
+    return b < a ? b : a;
+  }
+template <class T, class Compare>
+  inline const T& min(const T& a, const T& b, Compare comp)
+  {
+    return comp(b, a) ? b : a;
+  }
+template <class T>
+  inline const T& max(const T& a, const T& b)
+  {
+    return a < b ? b : a;
+  }
+template <class T, class Compare>
+  inline const T& max(const T& a, const T& b, Compare comp)
+  {
+    return comp(a, b) ? b : a;
+  }
+
+
+/**
+ * swap() / iter_swap()
+ */
+template <class T>
+  inline void swap(T& a, T& b)
+  {
+    T tmp = a;
+    a = b;
+    b = tmp;
+  }
+template <class ForwardIterator1, class ForwardIterator2>
+  inline void iter_swap(ForwardIterator1 a, ForwardIterator2 b)
+  {
+    typename iterator_traits<ForwardIterator1>::value_type tmp = *a;
+    *a = *b;
+    *b = tmp;
+  }
+
+
+/**
+ * copy(first, last, result)
+ * 将 [first, last) 复制到 [result, result + (last - first))
+ * 原生指针且元素具有 trivial assignment operator 时，以 memmove() 整块搬移
+ */
+template <class InputIterator, class OutputIterator>
+  inline OutputIterator __copy(InputIterator first, InputIterator last, OutputIterator result,
+                               input_iterator_tag)
+  {
+    for ( ; first != last; ++result, ++first)
+      *result = *first;
+    return result;
+  }
+// 以距离 n 控制循环，比迭代器比较快
+template <class RandomAccessIterator, class OutputIterator>
+  inline OutputIterator __copy(RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                               random_access_iterator_tag)
+  {
+    typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+    for (Distance n = last - first; n > 0; --n, ++result, ++first)
+      *result = *first;
+    return result;
+  }
+template <class T>
+  inline T* __copy_t(const T* first, const T* last, T* result, __true_type)
+  {
+    const ptrdiff_t n = last - first;
+    if (n != 0) memmove(result, first, sizeof(T) * n); // 空区间可能是空指针
+    return result + n;
+  }
+template <class T>
+  inline T* __copy_t(const T* first, const T* last, T* result, __false_type)
+  {
+    return __copy(first, last, result, random_access_iterator_tag());
+  }
+// 以偏特化区分原生指针
+template <class InputIterator, class OutputIterator>
+  struct __copy_dispatch
+  {
+    OutputIterator operator()(InputIterator first, InputIterator last, OutputIterator result)
+    {
+      return __copy(first, last, result, iterator_category(first));
+    }
+  };
+template <class T>
+  struct __copy_dispatch<T*, T*>
+  {
+    T* operator()(T* first, T* last, T* result)
+    {
+      typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+      return __copy_t((const T*)first, (const T*)last, result, t());
+    }
+  };
+template <class T>
+  struct __copy_dispatch<const T*, T*>
+  {
+    T* operator()(const T* first, const T* last, T* result)
+    {
+      typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+      return __copy_t(first, last, result, t());
+    }
+  };
+template <class InputIterator, class OutputIterator>
+  inline OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result)
+  {
+    return __copy_dispatch<InputIterator, OutputIterator>()(first, last, result);
+  }
+
+
+/**
+ * copy_backward(first, last, result)
+ * 由尾至头复制，result 为目的区间的尾
+ */
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+  inline BidirectionalIterator2 __copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                                BidirectionalIterator2 result)
+  {
+    while (first != last) *--result = *--last;
+    return result;
+  }
+template <class T>
+  inline T* __copy_backward_t(const T* first, const T* last, T* result, __true_type)
+  {
+    const ptrdiff_t n = last - first;
+    if (n != 0) memmove(result - n, first, sizeof(T) * n);
+    return result - n;
+  }
+template <class T>
+  inline T* __copy_backward_t(const T* first, const T* last, T* result, __false_type)
+  {
+    return __copy_backward(first, last, result);
+  }
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+  struct __copy_backward_dispatch
+  {
+    BidirectionalIterator2 operator()(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                      BidirectionalIterator2 result)
+    {
+      return __copy_backward(first, last, result);
+    }
+  };
+template <class T>
+  struct __copy_backward_dispatch<T*, T*>
+  {
+    T* operator()(T* first, T* last, T* result)
+    {
+      typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+      return __copy_backward_t((const T*)first, (const T*)last, result, t());
+    }
+  };
+template <class T>
+  struct __copy_backward_dispatch<const T*, T*>
+  {
+    T* operator()(const T* first, const T* last, T* result)
+    {
+      typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+      return __copy_backward_t(first, last, result, t());
+    }
+  };
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+  inline BidirectionalIterator2 copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                              BidirectionalIterator2 result)
+  {
+    return __copy_backward_dispatch<BidirectionalIterator1, BidirectionalIterator2>()(first, last, result);
+  }
+
+
+/**
+ * fill(first, last, value) / fill_n(first, n, value)
+ */
+template <class ForwardIterator, class T>
+  inline void fill(ForwardIterator first, ForwardIterator last, const T& value)
+  {
+    for ( ; first != last; ++first)
+      *first = value;
+  }
+template <class OutputIterator, class Size, class T>
+  inline OutputIterator fill_n(OutputIterator first, Size n, const T& value)
+  {
+    for ( ; n > 0; --n, ++first)
+      *first = value;
+    return first;
+  }
+// 针对单字节型别以 memset() 填充
+inline void fill(char* first, char* last, const char& c)
+{
+  memset(first, c, last - first);
+}
+inline void fill(unsigned char* first, unsigned char* last, const unsigned char& c)
+{
+  memset(first, c, last - first);
+}
+
 } // namespace tinystl
 
 #endif // !TINYSTL_ALGOBASE_H_
-
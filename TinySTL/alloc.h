@@ -9,44 +9,13 @@
 #ifndef TINYSTL_ALLOC_H_
 #define TINYSTL_ALLOC_H_
 
+#include <stddef.h> // size_t
+#include <stdlib.h> // malloc(), realloc(), free(), exit()
+#include <iostream>  // __THROW_BAD_ALLOC
+
 namespace tinystl
 {
 
-typedef __malloc_alloc_template<0> malloc_alloc;
-// 令 alloc 为第一级配置器
-// typedef malloc_alloc alloc;
-// 令 alloc 为第二级配置器
-// false 表示不考虑多线程。
-typedef __default_alloc_template<false, 0> alloc;
-
-// SGI包装的，符合STL规范的，对外使用的配置器接口
-template <class T, class Alloc>
-  class simple_alloc
-  {
-    public:
-    static T* allocate(size_t n)
-    {
-      return 0 == n ? \
-             0 : \
-             (T*)Alloc::allocate(n * sizeof(T));
-    }
-    static T* allocate(void)
-    {
-      return 0 == n ? \
-             0 : \
-             (T*)Alloc::allocate(sizeof(T));
-    }
-    static void deallocate(T* p, size_t n)
-    {
-      if (0 != n) Alloc::deallocate(p, n * sizeof(T));
-    }
-    static void deallocate(T* p)
-    {
-      Alloc::deallocate(p, sizeof(T));
-    }
-  };
-
-
 /**
  * 第一级配置器
  */
@@ -54,9 +23,8 @@ template <class T, class Alloc>
 #   include <new>
 #   define __THROW_BAD_ALLOC throw std::bad_alloc;
 #elif !defined(__THROW_BAD_ALLOC)
-#   include <iostream>
 #   define __THROW_BAD_ALLOC \
-           std::cerr << "out of memory" << endl; \
+           std::cerr << "out of memory" << std::endl; \
            exit(1);
 #endif
 
@@ -86,6 +54,9 @@ template <int inst>
       if (0 == result) result = oom_realloc(p, new_sz);
       return result;
     }
+    // 配置 n bytes 时实际可用的大小
+    // malloc() 的额外空间依实现而定，保守地视为 n
+    static size_t usable_size(size_t n) { return n; }
 
     // 以下仿真C++的 set_new_handler()。
     // 因为没有用 ::operator new ，且C++没有提供与 realloc() 相关操作，所以不能用。
@@ -97,6 +68,8 @@ template <int inst>
     }
   };
 
+typedef __malloc_alloc_template<0> malloc_alloc;
+
 // 初值为零，应由客端设定
 template <int inst>
   void (* __malloc_alloc_template<inst>::__malloc_alloc_oom_handler)() \
@@ -178,7 +151,7 @@ template <bool threads, int inst>
     // 根据区块大小，决定使用几号 free-list
     static size_t FREELIST_INDEX(size_t bytes)
     {
-      return ((bytes + __ALIGN-1) / __ALIGN - 1)
+      return ((bytes + __ALIGN-1) / __ALIGN - 1);
     }
 
     // 通过 chunk_alloc 扩充大小为 size 的自由链表
@@ -233,6 +206,14 @@ template <bool threads, int inst>
       *my_free_list = q;
     }
     static void* reallocate(void* p, size_t old_sz, size_t new_sz);
+
+    // 配置 n bytes 时实际交付的区块大小
+    // 小额区块被上调至 8 的倍数，多出的空间可由容器直接利用
+    static size_t usable_size(size_t n)
+    {
+      if (n > (size_t)__MAX_BYTES) return malloc_alloc::usable_size(n);
+      return ROUND_UP(n);
+    }
   };
 
 
@@ -276,10 +257,10 @@ template <bool threads, int inst>
     result = (obj*)chunk; //第一块返回给调用者
     *my_free_list = next_obj = (obj*)(chunk + n);
     for (i=1;  ; ++i) { //从 1 开始，因为第 0 个返回给调用者
-      current_obj -> next_obj;
+      current_obj = next_obj;
       next_obj = (obj*)((char*)next_obj + n);
       if (nobjs - 1 == i) {
-        chrrent_obj -> free_list_link = 0;
+        current_obj -> free_list_link = 0;
         break;
       } else {
         current_obj -> free_list_link = next_obj;
@@ -311,14 +292,15 @@ template <bool threads, int inst>
       // 先将内存池剩余空间配给合适的链表
       if (bytes_left > 0) {
         obj* volatile* my_free_list = free_list + FREELIST_INDEX(bytes_left);
-        (obj*)start_free -> free_list_link = *my_free_list;
+        ((obj*)start_free) -> free_list_link = *my_free_list;
         *my_free_list = (obj*)start_free;
       }
       // 配置 heap 空间，补充内存池
       start_free = (char*)malloc(bytes_to_get);
       if (0 == start_free) { // heap 空间不足，配置失败
         int i;
-        obj* volatile* my_free_list, * p;
+        obj* volatile* my_free_list;
+        obj* p;
         // 优先检视所有区块足够大的链表，并将其重新划分到当前链表，
         // 并不配置较小区块。在多线程(multi-process)机器上会导致灾难。
         for (i=size; i<=__MAX_BYTES; i+=__ALIGN) {
@@ -345,6 +327,38 @@ template <bool threads, int inst>
     }
   }
 
+
+// 令 alloc 为第一级配置器
+// typedef malloc_alloc alloc;
+// 令 alloc 为第二级配置器
+// false 表示不考虑多线程。
+typedef __default_alloc_template<false, 0> alloc;
+
+// SGI包装的，符合STL规范的，对外使用的配置器接口
+template <class T, class Alloc>
+  class simple_alloc
+  {
+    public:
+    static T* allocate(size_t n)
+    {
+      return 0 == n ? \
+             0 : \
+             (T*)Alloc::allocate(n * sizeof(T));
+    }
+    static T* allocate(void)
+    {
+      return (T*)Alloc::allocate(sizeof(T));
+    }
+    static void deallocate(T* p, size_t n)
+    {
+      if (0 != n) Alloc::deallocate(p, n * sizeof(T));
+    }
+    static void deallocate(T* p)
+    {
+      Alloc::deallocate(p, sizeof(T));
+    }
+  };
+
 } // namespace tinystl
 
 #endif // !TINYSTL_ALLOC_H_
@@ -0,0 +1,318 @@
+
+/**
+ * circular_buffer
+ * 固定容量的环形缓冲区，容量为 2 的幂，元素位置为计数 & mask。
+ * 两端插入删除都是常数时间且不配置内存，可作为 queue / stack 的底部结构(Sequence)，
+ * 适合最近事件的窗口、滑动窗口等有界的缓冲。
+ *
+ * head 为不断递增的计数，迭代器也以计数记录位置，
+ * 两端的插入删除不会使其他元素的迭代器失效(容量改变时除外)。
+ *
+ * 已满时的行为由 Policy 决定：
+ *   circular_buffer_overwrite   覆盖另一端最旧的元素(缺省)
+ *   circular_buffer_reject      放弃这次写入，push_xxx() 传回 false
+ *   circular_buffer_grow        容量加倍，与 deque 一样可无限增长
+ *
+ * 缺省构造的容量为 __CIRCULAR_BUFFER_DEFAULT_CAPACITY，所以 queue<T, circular_buffer<T> >
+ * 保留最近的这些元素；作为不会遗失元素的 queue / stack 时请使用 circular_buffer_grow。
+ */
+#ifndef TINYSTL_CIRCULAR_BUFFER_H_
+#define TINYSTL_CIRCULAR_BUFFER_H_
+
+#include "alloc.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace tinystl
+{
+
+enum { __CIRCULAR_BUFFER_DEFAULT_CAPACITY = 16 }; // 缺省构造的容量，2 的幂
+
+/**
+ * 已满时的处理策略(full policy)
+ * make_room_back(b) / make_room_front(b) 在尾端 / 前端写入前调用，
+ * 传回 true 表示已腾出空间，false 表示放弃写入
+ */
+struct circular_buffer_overwrite
+{
+  template <class Buffer>
+    static bool make_room_back(Buffer& b)
+    {
+      if (b.capacity() == 0) return false;
+      b.pop_front();
+      return true;
+    }
+  template <class Buffer>
+    static bool make_room_front(Buffer& b)
+    {
+      if (b.capacity() == 0) return false;
+      b.pop_back();
+      return true;
+    }
+};
+struct circular_buffer_reject
+{
+  template <class Buffer>
+    static bool make_room_back(Buffer&) { return false; }
+  template <class Buffer>
+    static bool make_room_front(Buffer&) { return false; }
+};
+struct circular_buffer_grow
+{
+  template <class Buffer>
+    static bool make_room_back(Buffer& b)
+    {
+      b.reserve(b.capacity() == 0 ? 8 : 2 * b.capacity());
+      return true;
+    }
+  template <class Buffer>
+    static bool make_room_front(Buffer& b) { return make_room_back(b); }
+};
+
+
+// circular_buffer 迭代器
+template <class T, class Ref, class Ptr>
+  struct __circular_buffer_iterator
+  {
+    typedef __circular_buffer_iterator<T, T&, T*>               iterator;
+    typedef __circular_buffer_iterator<T, const T&, const T*>   const_iterator;
+    typedef __circular_buffer_iterator                          self;
+
+    typedef random_access_iterator_tag    iterator_category;
+    typedef T                             value_type;
+    typedef Ptr                           pointer;
+    typedef Ref                           reference;
+    typedef ptrdiff_t                     difference_type;
+    typedef size_t                        size_type;
+
+    T* buf;
+    size_type mask;
+    size_type pos; // 计数，实际位置为 pos & mask
+
+    __circular_buffer_iterator() : buf(0), mask(0), pos(0) { }
+    __circular_buffer_iterator(T* b, size_type m, size_type p) : buf(b), mask(m), pos(p) { }
+    __circular_buffer_iterator(const iterator& x) : buf(x.buf), mask(x.mask), pos(x.pos) { }
+
+    reference operator*() const { return buf[pos & mask]; }
+    pointer operator->() const { return &(operator*()); }
+    // 计数可能绕回，差值以有号数解读
+    difference_type operator-(const self& x) const { return difference_type(pos - x.pos); }
+    self& operator++() { ++pos; return *this; }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++pos;
+      return tmp;
+    }
+    self& operator--() { --pos; return *this; }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --pos;
+      return tmp;
+    }
+    self& operator+=(difference_type n) { pos += size_type(n); return *this; }
+    self operator+(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp += n;
+    }
+    self& operator-=(difference_type n) { pos -= size_type(n); return *this; }
+    self operator-(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp -= n;
+    }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bool operator==(const self& x) const { return pos == x.pos; }
+    bool operator!=(const self& x) const { return pos != x.pos; }
+    bool operator<(const self& x) const { return difference_type(pos - x.pos) < 0; }
+  };
+
+
+template <class T, class Alloc = alloc, class Policy = circular_buffer_overwrite>
+  class circular_buffer
+  {
+    public:
+    typedef T                                                   value_type;
+    typedef value_type*                                         pointer;
+    typedef value_type&                                         reference;
+    typedef const value_type&                                   const_reference;
+    typedef size_t                                              size_type;
+    typedef ptrdiff_t                                           difference_type;
+    typedef __circular_buffer_iterator<T, T&, T*>               iterator;
+    typedef __circular_buffer_iterator<T, const T&, const T*>   const_iterator;
+
+    protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+
+    T* buf;
+    size_type cap;    // 0 或 2 的幂
+    size_type head;   // 第一个元素的计数
+    size_type count;  // 元素个数
+
+    size_type mask() const { return cap - 1; }
+    T* slot(size_type i) const { return buf + (i & mask()); }
+    static size_type round_up(size_type n)
+    {
+      size_type c = 1;
+      while (c < n) c <<= 1;
+      return c;
+    }
+    // 依序复制至新配置的连续空间 [p, p + count)
+    void copy_to(T* p) const;
+
+    public:
+    // 容量为 __CIRCULAR_BUFFER_DEFAULT_CAPACITY，之后可以 reserve() 扩充
+    circular_buffer() : buf(0), cap(__CIRCULAR_BUFFER_DEFAULT_CAPACITY), head(0), count(0)
+    {
+      buf = data_allocator::allocate(cap);
+    }
+    // 容量向上取至 2 的幂
+    explicit circular_buffer(size_type n) : buf(0), cap(0), head(0), count(0)
+    {
+      if (n != 0) {
+        cap = round_up(n);
+        buf = data_allocator::allocate(cap);
+      }
+    }
+    circular_buffer(const circular_buffer& x) : buf(0), cap(x.cap), head(0), count(0)
+    {
+      if (cap != 0) {
+        buf = data_allocator::allocate(cap);
+        try {
+          x.copy_to(buf);
+        } catch(...) {
+          data_allocator::deallocate(buf, cap);
+          throw;
+        }
+        count = x.count;
+      }
+    }
+    ~circular_buffer()
+    {
+      clear();
+      if (buf) data_allocator::deallocate(buf, cap);
+    }
+    circular_buffer& operator=(const circular_buffer& x)
+    {
+      if (this != &x) {
+        circular_buffer tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(circular_buffer& x)
+    {
+      T* p = buf; buf = x.buf; x.buf = p;
+      size_type n = cap; cap = x.cap; x.cap = n;
+      n = head; head = x.head; x.head = n;
+      n = count; count = x.count; x.count = n;
+    }
+
+    iterator begin() { return iterator(buf, mask(), head); }
+    const_iterator begin() const { return const_iterator(buf, mask(), head); }
+    iterator end() { return iterator(buf, mask(), head + count); }
+    const_iterator end() const { return const_iterator(buf, mask(), head + count); }
+    size_type size() const { return count; }
+    size_type capacity() const { return cap; }
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == cap; }
+
+    reference operator[](size_type n) { return *slot(head + n); }
+    const_reference operator[](size_type n) const { return *slot(head + n); }
+    reference front() { return *slot(head); }
+    const_reference front() const { return *slot(head); }
+    reference back() { return *slot(head + count - 1); }
+    const_reference back() const { return *slot(head + count - 1); }
+
+    // 容量扩充至不小于 n 的 2 的幂，元素重新排列于开头，迭代器失效
+    void reserve(size_type n);
+
+    // 已满时依 Policy 处理，放弃写入时传回 false
+    // Policy 会析构或搬移元素，x 可能就是其中之一，因此先复制一份
+    bool push_back(const value_type& x)
+    {
+      if (count == cap) {
+        value_type x_copy = x;
+        if (!Policy::make_room_back(*this)) return false;
+        construct(slot(head + count), x_copy);
+      } else
+        construct(slot(head + count), x);
+      ++count;
+      return true;
+    }
+    bool push_front(const value_type& x)
+    {
+      if (count == cap) {
+        value_type x_copy = x;
+        if (!Policy::make_room_front(*this)) return false;
+        construct(slot(head - 1), x_copy);
+      } else
+        construct(slot(head - 1), x);
+      --head;
+      ++count;
+      return true;
+    }
+    void pop_front()
+    {
+      tinystl::destroy(slot(head));
+      ++head;
+      --count;
+    }
+    void pop_back()
+    {
+      --count;
+      tinystl::destroy(slot(head + count));
+    }
+    void clear()
+    {
+      while (count != 0) pop_back();
+      head = 0;
+    }
+  };
+
+template <class T, class Alloc, class Policy>
+  void circular_buffer<T, Alloc, Policy>::copy_to(T* p) const
+  {
+    if (count == 0) return;
+    // 元素在环形空间中至多分成两段
+    const T* first = slot(head);
+    const size_type len = tinystl::min(count, size_type(buf + cap - first));
+    tinystl::uninitialized_copy(first, first + len, p);
+    try {
+      tinystl::uninitialized_copy((const T*)buf, (const T*)buf + (count - len), p + len);
+    } catch(...) {
+      tinystl::destroy(p, p + len);
+      throw;
+    }
+  }
+
+template <class T, class Alloc, class Policy>
+  void circular_buffer<T, Alloc, Policy>::reserve(size_type n)
+  {
+    if (n <= cap) return;
+    const size_type new_cap = round_up(n);
+    T* new_buf = data_allocator::allocate(new_cap);
+    try {
+      copy_to(new_buf);
+    } catch(...) {
+      data_allocator::deallocate(new_buf, new_cap);
+      throw;
+    }
+    const size_type n_elems = count;
+    clear();
+    if (buf) data_allocator::deallocate(buf, cap);
+    buf = new_buf;
+    cap = new_cap;
+    head = 0;
+    count = n_elems;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_CIRCULAR_BUFFER_H_
@@ -0,0 +1,431 @@
+
+/**
+ * colony
+ * 无序容器，元素存放于一连串固定大小的区块(group)，区块大小随元素总数成长。
+ * 插入、删除都不搬移其他元素，指向元素的指针与迭代器在元素删除前始终有效。
+ *
+ * 被删除的位置以 skipfield 记录，并于之后的插入中重用：
+ *   连续的空位组成一个区段(skipblock)，区段头尾两格记录区段长度，
+ *   走访时 ++ 落在区段头便一次跳过整个区段，每个元素 O(1)。
+ *   每个区块的区段串成双向链表，链表节点就存放在空位的元素空间内。
+ * 区块中的元素全部删除后，区块归还配置器(最后一个区块保留以备重用)。
+ *
+ * 迭代器为 Bidirectional Iterator，走访次序不等于插入次序。
+ */
+#ifndef TINYSTL_COLONY_H_
+#define TINYSTL_COLONY_H_
+
+#include <string.h> // for memset()
+#include "alloc.h"
+#include "iterator.h"
+#include "construct.h"
+
+namespace tinystl
+{
+
+typedef unsigned short __colony_skip_type;
+
+enum
+{
+  __COLONY_MIN_GROUP = 8,     // 第一个区块的大小
+  __COLONY_MAX_GROUP = 8192,  // 区块大小的上限，必须小于 __COLONY_NO_SLOT
+  __COLONY_NO_SLOT = 0xFFFF   // 空位链表的结尾
+};
+
+// 一格元素空间，元素删除后改存空位链表的前后节点
+template <class T>
+  struct __colony_slot
+  {
+    struct links
+    {
+      __colony_skip_type prev;
+      __colony_skip_type next;
+    };
+    alignas(T) alignas(links) char data[sizeof(T) > sizeof(links) ? sizeof(T) : sizeof(links)];
+
+    T* value() { return reinterpret_cast<T*>(data); }
+    links& free_links() { return *reinterpret_cast<links*>(data); }
+  };
+
+// 区块
+template <class T>
+  struct __colony_group
+  {
+    typedef __colony_slot<T>      slot_type;
+    typedef __colony_skip_type    skip_type;
+
+    slot_type* slots;
+    skip_type* skip;      // capacity + 1 格，最后一格恒为 0
+    size_t capacity;
+    size_t last;          // 使用过的格数，其后的空间尚未构造
+    size_t size;          // 现有元素个数
+    size_t free_head;     // 第一个空位区段的起点
+    __colony_group* prev;
+    __colony_group* next;
+    __colony_group* erasures_prev; // 含空位的区块另串成链表
+    __colony_group* erasures_next;
+
+    bool has_free() const { return free_head != __COLONY_NO_SLOT; }
+
+    // 空位区段链表的维护，参数皆为区段起点
+    void free_push(size_t s)
+    {
+      typename slot_type::links& l = slots[s].free_links();
+      l.prev = __COLONY_NO_SLOT;
+      l.next = skip_type(free_head);
+      if (has_free()) slots[free_head].free_links().prev = skip_type(s);
+      free_head = s;
+    }
+    void free_remove(size_t s)
+    {
+      typename slot_type::links l = slots[s].free_links();
+      if (l.prev != __COLONY_NO_SLOT) slots[l.prev].free_links().next = l.next;
+      else free_head = l.next;
+      if (l.next != __COLONY_NO_SLOT) slots[l.next].free_links().prev = l.prev;
+    }
+    // 区段起点由 from 移至 to
+    void free_move(size_t from, size_t to)
+    {
+      typename slot_type::links l = slots[from].free_links();
+      slots[to].free_links() = l;
+      if (l.prev != __COLONY_NO_SLOT) slots[l.prev].free_links().next = skip_type(to);
+      else free_head = to;
+      if (l.next != __COLONY_NO_SLOT) slots[l.next].free_links().prev = skip_type(to);
+    }
+
+    // 第 i 格的元素已析构，将其并入相邻的空位区段
+    void mark_erased(size_t i)
+    {
+      const size_t left = i > 0 ? skip[i - 1] : 0;
+      const size_t right = skip[i + 1];
+      if (left == 0 && right == 0) {
+        skip[i] = 1;
+        free_push(i);
+      } else if (right == 0) { // 接在左侧区段之后
+        skip[i - left] = skip[i] = skip_type(left + 1);
+      } else if (left == 0) { // 成为右侧区段的新起点
+        skip[i] = skip[i + right] = skip_type(right + 1);
+        free_move(i + 1, i);
+      } else { // 连接左右两个区段
+        free_remove(i + 1);
+        skip[i - left] = skip[i + right] = skip_type(left + right + 1);
+        skip[i] = 1; // 区段内部只需非 0
+      }
+    }
+    // 取出第一个空位区段的起点
+    size_t take_free()
+    {
+      const size_t s = free_head;
+      const size_t len = skip[s];
+      if (len == 1)
+        free_remove(s);
+      else {
+        free_move(s, s + 1);
+        skip[s + 1] = skip[s + len - 1] = skip_type(len - 1);
+      }
+      skip[s] = 0;
+      return s;
+    }
+  };
+
+// colony 迭代器
+template <class T, class Ref, class Ptr>
+  struct __colony_iterator
+  {
+    typedef __colony_iterator<T, T&, T*>     iterator;
+    typedef __colony_iterator<T, Ref, Ptr>   self;
+    typedef __colony_group<T>*               group_pointer;
+    typedef size_t                           size_type;
+
+    typedef bidirectional_iterator_tag       iterator_category;
+    typedef T                                value_type;
+    typedef Ptr                              pointer;
+    typedef Ref                              reference;
+    typedef ptrdiff_t                        difference_type;
+
+    group_pointer group;
+    size_type index;
+
+    __colony_iterator(group_pointer g, size_type i) : group(g), index(i) { }
+    __colony_iterator() : group(0), index(0) { }
+    __colony_iterator(const iterator& x) : group(x.group), index(x.index) { }
+
+    bool operator==(const self& x) const { return index == x.index && group == x.group; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+    reference operator*() const { return *group->slots[index].value(); }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      ++index;
+      index += group->skip[index];
+      // 最后一个区块的 last 即为 end()
+      if (index == group->last && group->next) {
+        group = group->next;
+        index = group->skip[0];
+      }
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self& operator--()
+    {
+      for ( ; ; ) {
+        if (index == 0) {
+          group = group->prev;
+          index = group->last;
+        }
+        --index;
+        const size_type s = group->skip[index];
+        if (s <= index) { // 落在区段尾时跳至区段之前
+          index -= s;
+          return *this;
+        }
+        index = 0; // 区段延伸至区块开头，继续往前一个区块找
+      }
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+  };
+
+
+template <class T, class Alloc = alloc>
+  class colony
+  {
+    public:
+    typedef T                                         value_type;
+    typedef value_type*                               pointer;
+    typedef const value_type*                         const_pointer;
+    typedef value_type&                               reference;
+    typedef const value_type&                         const_reference;
+    typedef size_t                                    size_type;
+    typedef ptrdiff_t                                 difference_type;
+    typedef __colony_iterator<T, T&, T*>              iterator;
+    typedef __colony_iterator<T, const T&, const T*>  const_iterator;
+
+    protected:
+    typedef __colony_group<T>                         group;
+    typedef group*                                    group_pointer;
+    typedef __colony_slot<T>                          slot_type;
+    typedef __colony_skip_type                        skip_type;
+    typedef simple_alloc<group, Alloc>                group_allocator;
+    typedef simple_alloc<slot_type, Alloc>            slot_allocator;
+    typedef simple_alloc<skip_type, Alloc>            skip_allocator;
+
+    group_pointer first_group;
+    group_pointer last_group;
+    group_pointer erasures;  // 含空位的区块
+    size_type num;
+
+    // 区块管理
+    group_pointer new_group(size_type n);
+    void delete_group(group_pointer g)
+    {
+      skip_allocator::deallocate(g->skip, g->capacity + 1);
+      slot_allocator::deallocate(g->slots, g->capacity);
+      group_allocator::deallocate(g);
+    }
+    void destroy_elements(group_pointer g)
+    {
+      for (size_type i = g->skip[0]; i < g->last; ) {
+        destroy(g->slots[i].value());
+        ++i;
+        i += g->skip[i];
+      }
+    }
+    // 清空最后一个区块以备重用
+    void reset_group(group_pointer g)
+    {
+      memset(g->skip, 0, (g->capacity + 1) * sizeof(skip_type));
+      g->last = g->size = 0;
+      g->free_head = __COLONY_NO_SLOT;
+    }
+    void unlink_group(group_pointer g)
+    {
+      if (g->prev) g->prev->next = g->next;
+      else first_group = g->next;
+      if (g->next) g->next->prev = g->prev;
+      else last_group = g->prev;
+    }
+    void erasures_push(group_pointer g)
+    {
+      g->erasures_prev = 0;
+      g->erasures_next = erasures;
+      if (erasures) erasures->erasures_prev = g;
+      erasures = g;
+    }
+    void erasures_remove(group_pointer g)
+    {
+      if (g->erasures_prev) g->erasures_prev->erasures_next = g->erasures_next;
+      else erasures = g->erasures_next;
+      if (g->erasures_next) g->erasures_next->erasures_prev = g->erasures_prev;
+    }
+    // 新区块的大小约等于现有元素总数，使区块个数按对数成长
+    size_type next_group_capacity() const
+    {
+      size_type n = num < size_type(__COLONY_MIN_GROUP) ? size_type(__COLONY_MIN_GROUP) : num;
+      return n > size_type(__COLONY_MAX_GROUP) ? size_type(__COLONY_MAX_GROUP) : n;
+    }
+
+    public:
+    colony() : first_group(0), last_group(0), erasures(0), num(0) { }
+    colony(const colony& x) : first_group(0), last_group(0), erasures(0), num(0)
+    {
+      try {
+        for (const_iterator i = x.begin(); i != x.end(); ++i)
+          insert(*i);
+      } catch(...) {
+        clear();
+        throw;
+      }
+    }
+    ~colony() { clear(); }
+    colony& operator=(const colony& x)
+    {
+      if (this != &x) {
+        colony tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(colony& x)
+    {
+      group_pointer tmp = first_group; first_group = x.first_group; x.first_group = tmp;
+      tmp = last_group; last_group = x.last_group; x.last_group = tmp;
+      tmp = erasures; erasures = x.erasures; x.erasures = tmp;
+      size_type n = num; num = x.num; x.num = n;
+    }
+
+    iterator begin() { return first_group ? iterator(first_group, first_group->skip[0]) : iterator(); }
+    const_iterator begin() const
+    { return first_group ? const_iterator(first_group, first_group->skip[0]) : const_iterator(); }
+    iterator end() { return last_group ? iterator(last_group, last_group->last) : iterator(); }
+    const_iterator end() const
+    { return last_group ? const_iterator(last_group, last_group->last) : const_iterator(); }
+    size_type size() const { return num; }
+    bool empty() const { return num == 0; }
+
+    // 优先重用空位，否则附加于最后一个区块之后
+    iterator insert(const T& x);
+    // 传回下一个元素的迭代器，其余元素的指针与迭代器不受影响
+    iterator erase(iterator position);
+    void clear();
+    // 由元素的指针取得迭代器，花费与区块个数成正比
+    iterator get_iterator(const_pointer p);
+  };
+
+template <class T, class Alloc>
+  typename colony<T, Alloc>::group_pointer colony<T, Alloc>::new_group(size_type n)
+  {
+    group_pointer g = group_allocator::allocate();
+    g->slots = slot_allocator::allocate(n);
+    try {
+      g->skip = skip_allocator::allocate(n + 1);
+    } catch(...) {
+      slot_allocator::deallocate(g->slots, n);
+      group_allocator::deallocate(g);
+      throw;
+    }
+    g->capacity = n;
+    reset_group(g);
+    g->prev = g->next = 0;
+    g->erasures_prev = g->erasures_next = 0;
+    return g;
+  }
+
+template <class T, class Alloc>
+  typename colony<T, Alloc>::iterator colony<T, Alloc>::insert(const T& x)
+  {
+    if (erasures) {
+      group_pointer g = erasures;
+      const size_type s = g->take_free();
+      try {
+        construct(g->slots[s].value(), x);
+      } catch(...) {
+        g->mark_erased(s);
+        throw;
+      }
+      ++g->size;
+      ++num;
+      if (!g->has_free()) erasures_remove(g);
+      return iterator(g, s);
+    }
+    group_pointer g = last_group;
+    if (!g || g->last == g->capacity) {
+      g = new_group(next_group_capacity());
+      try {
+        construct(g->slots[0].value(), x);
+      } catch(...) {
+        delete_group(g);
+        throw;
+      }
+      g->prev = last_group;
+      if (last_group) last_group->next = g;
+      else first_group = g;
+      last_group = g;
+    } else
+      construct(g->slots[g->last].value(), x);
+    ++g->size;
+    ++num;
+    return iterator(g, g->last++);
+  }
+
+template <class T, class Alloc>
+  typename colony<T, Alloc>::iterator colony<T, Alloc>::erase(iterator position)
+  {
+    group_pointer g = position.group;
+    const size_type i = position.index;
+    iterator next = position;
+    ++next;
+    destroy(g->slots[i].value());
+    --num;
+    if (--g->size == 0) { // 区块已空
+      if (g->has_free()) erasures_remove(g);
+      if (g == last_group) {
+        reset_group(g);
+        return end();
+      }
+      unlink_group(g);
+      delete_group(g);
+      return next;
+    }
+    const bool had_free = g->has_free();
+    g->mark_erased(i);
+    if (!had_free) erasures_push(g);
+    return next;
+  }
+
+template <class T, class Alloc>
+  void colony<T, Alloc>::clear()
+  {
+    group_pointer g = first_group;
+    while (g) {
+      group_pointer next = g->next;
+      destroy_elements(g);
+      delete_group(g);
+      g = next;
+    }
+    first_group = last_group = erasures = 0;
+    num = 0;
+  }
+
+template <class T, class Alloc>
+  typename colony<T, Alloc>::iterator colony<T, Alloc>::get_iterator(const_pointer p)
+  {
+    const slot_type* s = reinterpret_cast<const slot_type*>(p);
+    for (group_pointer g = first_group; g; g = g->next)
+      if (s >= g->slots && s < g->slots + g->last)
+        return iterator(g, size_type(s - g->slots));
+    return end();
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_COLONY_H_
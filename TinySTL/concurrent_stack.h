@@ -0,0 +1,314 @@
+
+/**
+ * concurrent_stack
+ * 不需要锁(lock-free)的并发 LIFO(Treiber stack)，适合在执行绪之间回收、重用物件。
+ * 节点即 slist 的 __slist_node，push / pop 以 CAS 更新栈顶。
+ *
+ * ABA：pop 读取栈顶 A 与 A->next 之后，其他执行绪可能取走 A 再放回，
+ * 栈顶仍是 A 但 next 已经不同。栈顶与一个计数(tag)存放在同一个 64 位元字组，
+ * 每次更新都递增计数，单字 CAS 便能同时比较两者：
+ *   64 位元平台的使用者空间位址只用到低 48 位元，计数放在高 16 位元；
+ *   32 位元平台指针与计数各占 32 位元。
+ *
+ * 节点向配置器一次取一整块(chunk)，pop 后的节点回到 concurrent_stack 自己的空闲栈，
+ * 直到 concurrent_stack 解构才释还。因此 pop 读取的节点即使刚被别人取走，内存仍然有效。
+ * 整块大于 __MAX_BYTES，alloc 直接交给 malloc()，可在多个执行绪间配置。
+ *
+ * 区间 push 先在本地串好整条链，再以一次 CAS 接上；pop_all 以一次 CAS 取下整个栈。
+ *
+ * 以节点为单位回收物件时，可直接操作节点链，元素不必复制：
+ *   make_node(x)             向本栈的空闲节点取一个节点并构造 x，next 为 0，尚未放入栈中
+ *   push_chain(first, last)  将以 next 串好的 first -> ... -> last 以一次 CAS 接在栈顶
+ *   pop_chain()              以一次 CAS 取下整个栈，传回以 0 结尾的链，元素仍在节点中
+ *   destroy_chain(first)     析构以 0 结尾的链上的元素，节点放回空闲栈
+ * 节点的内存属于取得它的 concurrent_stack，只能放回同一个栈；
+ * 栈解构前，取出的节点必须已经 push_chain() 或 destroy_chain()。
+ */
+#ifndef TINYSTL_CONCURRENT_STACK_H_
+#define TINYSTL_CONCURRENT_STACK_H_
+
+#include <stdint.h> // for uintptr_t
+#include <atomic>
+#include <mutex>
+#include "alloc.h"
+#include "slist.h"
+#include "construct.h"
+
+namespace tinystl
+{
+
+enum
+{
+  __CSTACK_LINE = 64,                                   // cache line 的大小
+  __CSTACK_CHUNK_BYTES = 4096,                          // 一次配置的节点空间
+  __CSTACK_TAG_SHIFT = sizeof(void*) == 8 ? 48 : 32     // 计数在字组中的位置
+};
+
+typedef unsigned long long __cstack_word; // 指针与计数
+
+inline __cstack_word __cstack_pack(__slist_node_base* p, __cstack_word tag)
+{
+  return (__cstack_word)(uintptr_t)p | (tag << __CSTACK_TAG_SHIFT);
+}
+inline __slist_node_base* __cstack_ptr(__cstack_word w)
+{
+  return (__slist_node_base*)(uintptr_t)(w & ((__cstack_word(1) << __CSTACK_TAG_SHIFT) - 1));
+}
+inline __cstack_word __cstack_next_tag(__cstack_word w)
+{
+  return (w >> __CSTACK_TAG_SHIFT) + 1;
+}
+
+// 节点的 next 可能在 pop 读取的同时被另一个执行绪改写(读到的值会被 CAS 否决)，
+// 以原子操作存取，避免资料竞争
+inline __slist_node_base* __cstack_load_next(__slist_node_base* p)
+{
+#if defined(__GNUC__)
+  return __atomic_load_n(&p->next, __ATOMIC_RELAXED);
+#else
+  return p->next;
+#endif
+}
+inline void __cstack_store_next(__slist_node_base* p, __slist_node_base* next)
+{
+#if defined(__GNUC__)
+  __atomic_store_n(&p->next, next, __ATOMIC_RELAXED);
+#else
+  p->next = next;
+#endif
+}
+
+// 带计数的栈顶，只串接节点，不涉及元素
+struct __cstack_top
+{
+  std::atomic<__cstack_word> word;
+
+  __cstack_top() : word(0) { }
+  bool empty() const { return __cstack_ptr(word.load(std::memory_order_relaxed)) == 0; }
+  // 将已串好的 first -> ... -> last 接在栈顶
+  void push_chain(__slist_node_base* first, __slist_node_base* last)
+  {
+    __cstack_word old = word.load(std::memory_order_relaxed);
+    __cstack_word w;
+    do {
+      __cstack_store_next(last, __cstack_ptr(old));
+      w = __cstack_pack(first, __cstack_next_tag(old));
+    } while (!word.compare_exchange_weak(old, w, std::memory_order_release,
+                                         std::memory_order_relaxed));
+  }
+  // 为空时传回 0
+  __slist_node_base* pop()
+  {
+    __cstack_word old = word.load(std::memory_order_acquire);
+    __slist_node_base* p;
+    do {
+      p = __cstack_ptr(old);
+      if (p == 0) return 0;
+    } while (!word.compare_exchange_weak(old, __cstack_pack(__cstack_load_next(p), __cstack_next_tag(old)),
+                                         std::memory_order_acquire, std::memory_order_acquire));
+    return p;
+  }
+  // 取下整个栈，传回以 0 结尾的链
+  __slist_node_base* pop_all()
+  {
+    __cstack_word old = word.load(std::memory_order_relaxed);
+    while (!word.compare_exchange_weak(old, __cstack_pack(0, __cstack_next_tag(old)),
+                                       std::memory_order_acquire, std::memory_order_relaxed))
+      ;
+    return __cstack_ptr(old);
+  }
+};
+
+
+template <class T, class Alloc = alloc>
+  class concurrent_stack
+  {
+    public:
+    typedef T                 value_type;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef size_t            size_type;
+    typedef __slist_node<T>   node_type; // data 为元素，next 串接下一个节点
+
+    protected:
+    typedef __slist_node<T>                     list_node;
+    typedef __slist_node_base                   list_node_base;
+    typedef simple_alloc<list_node, Alloc>      node_allocator;
+
+    // 每块的节点数，第一个节点用来串接各块
+    static size_type chunk_nodes()
+    {
+      return sizeof(list_node) * 2 > size_type(__CSTACK_CHUNK_BYTES) ?
+             2 : size_type(__CSTACK_CHUNK_BYTES) / sizeof(list_node);
+    }
+
+    __cstack_top top;
+    char pad[__CSTACK_LINE];
+    __cstack_top free_nodes;    // 空闲节点
+    std::mutex chunk_lock;      // 只在配置新的一块时使用
+    list_node* chunks;
+
+    list_node* get_node()
+    {
+      list_node_base* p = free_nodes.pop();
+      if (p) return (list_node*)p;
+      std::lock_guard<std::mutex> lock(chunk_lock);
+      if ((p = free_nodes.pop())) return (list_node*)p; // 等锁期间别人已补充
+      const size_type n = chunk_nodes();
+      list_node* c = node_allocator::allocate(n);
+      c->next = chunks;
+      chunks = c;
+      // c[1] 交给调用端，c[2..n) 串成一条放入空闲栈
+      if (n > 2) {
+        for (size_type i = 2; i + 1 < n; ++i)
+          c[i].next = c + i + 1;
+        free_nodes.push_chain(c + 2, c + n - 1);
+      }
+      return c + 1;
+    }
+    void put_node(list_node* p) { free_nodes.push_chain(p, p); }
+    list_node* create_node(const value_type& x)
+    {
+      list_node* p = get_node();
+      try {
+        construct(&p->data, x);
+      } catch(...) {
+        put_node(p);
+        throw;
+      }
+      return p;
+    }
+
+    private:
+    // 不可复制
+    concurrent_stack(const concurrent_stack&);
+    concurrent_stack& operator=(const concurrent_stack&);
+
+    public:
+    concurrent_stack() : chunks(0) { }
+    // 解构时不可再有其他执行绪使用
+    ~concurrent_stack()
+    {
+      for (list_node_base* p = top.pop_all(); p; p = p->next)
+        tinystl::destroy(&((list_node*)p)->data);
+      while (chunks) {
+        list_node* next = (list_node*)chunks->next;
+        node_allocator::deallocate(chunks, chunk_nodes());
+        chunks = next;
+      }
+    }
+
+    // 其他执行绪同时在操作时，只是某一瞬间的结果
+    bool empty() const { return top.empty(); }
+
+    void push(const value_type& x)
+    {
+      list_node* p = create_node(x);
+      top.push_chain(p, p);
+    }
+    // 节点链的操作，见档案开头的说明
+    node_type* make_node(const value_type& x)
+    {
+      list_node* p = create_node(x);
+      p->next = 0;
+      return p;
+    }
+    void push_chain(node_type* first, node_type* last) { top.push_chain(first, last); }
+    node_type* pop_chain() { return (node_type*)top.pop_all(); }
+    void destroy_chain(node_type* first);
+    // 依序 push [first, last)，整段以一次 CAS 接上，最后一个元素在栈顶
+    template <class InputIterator>
+      void push(InputIterator first, InputIterator last);
+
+    // 为空时传回 false
+    bool try_pop(value_type& x)
+    {
+      list_node* p = (list_node*)top.pop();
+      if (p == 0) return false;
+      try {
+        x = p->data;
+      } catch(...) { // 元素遗失，节点仍须回收
+        tinystl::destroy(&p->data);
+        put_node(p);
+        throw;
+      }
+      tinystl::destroy(&p->data);
+      put_node(p);
+      return true;
+    }
+    // 以一次 CAS 取下整个栈，由栈顶往下写至 result，传回元素个数
+    // 取下的节点再以一次 CAS 放回空闲栈
+    template <class OutputIterator>
+      size_type pop_all(OutputIterator result);
+  };
+
+template <class T, class Alloc>
+  template <class InputIterator>
+  void concurrent_stack<T, Alloc>::push(InputIterator first, InputIterator last)
+  {
+    if (first == last) return;
+    list_node* chain = 0; // 新的在前
+    list_node* tail = 0;
+    try {
+      for ( ; first != last; ++first) {
+        list_node* p = create_node(*first);
+        __cstack_store_next(p, chain);
+        chain = p;
+        if (tail == 0) tail = p;
+      }
+    } catch(...) {
+      destroy_chain(chain);
+      throw;
+    }
+    top.push_chain(chain, tail);
+  }
+
+template <class T, class Alloc>
+  void concurrent_stack<T, Alloc>::destroy_chain(node_type* first)
+  {
+    if (first == 0) return;
+    list_node_base* last = first;
+    for ( ; ; last = last->next) {
+      tinystl::destroy(&((list_node*)last)->data);
+      if (last->next == 0) break;
+    }
+    free_nodes.push_chain(first, last);
+  }
+
+template <class T, class Alloc>
+  template <class OutputIterator>
+  typename concurrent_stack<T, Alloc>::size_type
+  concurrent_stack<T, Alloc>::pop_all(OutputIterator result)
+  {
+    list_node_base* first = top.pop_all();
+    if (first == 0) return 0;
+    size_type n = 0;
+    list_node_base* last = first;
+    try {
+      for (list_node_base* p = first; ; p = p->next) {
+        *result = ((list_node*)p)->data;
+        ++result;
+        tinystl::destroy(&((list_node*)p)->data);
+        ++n;
+        last = p;
+        if (p->next == 0) break;
+      }
+    } catch(...) {
+      // 尚未写出的元素放回栈中，已写出的节点回收
+      list_node_base* rest = n == 0 ? first : last->next;
+      if (n != 0) {
+        last->next = 0;
+        free_nodes.push_chain(first, last);
+      }
+      list_node_base* rest_last = rest;
+      while (rest_last->next) rest_last = rest_last->next;
+      top.push_chain(rest, rest_last);
+      throw;
+    }
+    free_nodes.push_chain(first, last);
+    return n;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_CONCURRENT_STACK_H_
@@ -6,7 +6,7 @@
 #ifndef TINYSTL_CONSTRUCT_H_
 #define TINYSTL_CONSTRUCT_H_
 
-#include <new.h> // for placement new
+#include <new> // for placement new
 #include "type_traits.h"
 #include "iterator.h"
 
@@ -30,32 +30,33 @@ template <class T>
 
 // 析构2：
 // 删除区间元素
-// 获取删除元素类型
+// 元素数值型别(value type)有 non-trivial destructor
+// 以 != 结束，非 Random Access 的迭代器也适用
 template <class ForwardIterator>
-  inline void destroy(ForwardIterator first, ForwardIterator last)
+  inline void __destroy_aux(ForwardIterator first, ForwardIterator last,
+                            __false_type)
   {
-    __destroy(first, last, value_type(first));
+    for ( ; first != last; ++first) destroy(&*first);
   }
+// 元素数值型别(value type)有 trivial destructor
+template <class ForwardIterator>
+  inline void __destroy_aux(ForwardIterator, ForwardIterator,
+                            __true_type)
+  { }
 // 获取删除元素是否有必要调用析构函数
 template <class ForwardIterator, class T>
   inline void __destroy(ForwardIterator first, ForwardIterator last,
                         T*)
   {
     typedef typename __type_traits<T>::has_trivial_destructor trivial_destructor;
-    __destroy_aux(ForwardIterator first, ForwardIterator last, trivial_destructor());
+    __destroy_aux(first, last, trivial_destructor());
   }
-// 元素数值型别(value type)有 non-trivial destructor
-template <class ForwardIterator>
-    inline void __destroy_aux(ForwardIterator first, ForwardIterator last,
-                            __false_type)
-    {
-      for ( ; first < last; ++first) destroy(&*first);
-    }
-// 元素数值型别(value type)有 trivial destructor
+// 获取删除元素类型
 template <class ForwardIterator>
-  inline void __destroy_aux(ForwardIterator, ForwardIterator,
-                          __true_type)
-  { }
+  inline void destroy(ForwardIterator first, ForwardIterator last)
+  {
+    __destroy(first, last, value_type(first));
+  }
 
 // 析构2 对迭代器为 char* 和 wchar_t* 的特化版
 template <>
@@ -2,7 +2,12 @@
  * vector单开口连续空间，deque双开口连续空间(逻辑上看)。
  * deque允许常数时间对头端元素进行插入移除。
  * deque没有容量(capacity)观念。
- * 
+ *
+ * 缓冲区的元素个数一律为 2 的幂，迭代器随机存取时以移位与遮罩
+ * 取代除法与取余；缺省时一个缓冲区约为一个 page。
+ * 释放的缓冲区先暂存于 deque 内，头删尾插的 FIFO 用法在稳定后不再配置内存。
+ * 区间的 append / prepend / insert 与构造一次备妥所需的 map 节点与缓冲区，
+ * 再逐个缓冲区整段复制，元素 trivial 时即为 memmove。
  */
 #ifndef TINYSTL_DEQUE_H_
 #define TINYSTL_DEQUE_H_
@@ -16,19 +21,38 @@
 namespace tinystl
 {
 
-// 决定缓冲区大小
-// 如果 n 不为 0，传回 n；表示 buffer size 由用户自定义
-// 如果 n 为 0，表示 buffer size 使用默认值，那么
-//    如果 sz(元素大小，sizeof(value_type)) 小于 512，传回 512/sz
-//    如果 sz 不小于 512.传回 1
-inline size_t __deque_buf_size(size_t n, size_t sz)
+enum
 {
-  return 0 != n ? \
-         n : \
-         sz < 512 ? \
-         size_t(512/ sz) : \
-         size_t(1);
-}
+  __DEQUE_BUF_BYTES = 4096, // 缺省缓冲区大小，一个 page
+  __DEQUE_SPARE_NODES = 2 // 每个 deque 暂存的空闲缓冲区个数
+};
+
+// 编译期求 floor(log2(n))
+template <size_t n>
+  struct __deque_log2 { enum { value = 1 + __deque_log2<n / 2>::value }; };
+template <>
+  struct __deque_log2<1> { enum { value = 0 }; };
+template <>
+  struct __deque_log2<0> { enum { value = 0 }; };
+
+// 决定缓冲区大小，以 2 的幂次表示，缓冲区可容纳 1 << shift 个元素
+// 如果 n 不为 0，表示 buffer size 由用户自定义，向上取至 2 的幂
+// 如果 n 为 0，表示 buffer size 使用默认值，那么
+//    如果 sz(元素大小，sizeof(value_type)) 小于 __DEQUE_BUF_BYTES，
+//    取 __DEQUE_BUF_BYTES/sz 向下取至 2 的幂
+//    如果 sz 不小于 __DEQUE_BUF_BYTES，缓冲区只放 1 个元素
+template <size_t n, size_t sz>
+  struct __deque_buf_shift
+  {
+    enum
+    {
+      value = n != 0 ? \
+              __deque_log2<2 * n - 1>::value : \
+              sz < size_t(__DEQUE_BUF_BYTES) ? \
+              __deque_log2<size_t(__DEQUE_BUF_BYTES) / sz>::value : \
+              0
+    };
+  };
 
 
 // deque迭代器
@@ -37,10 +61,12 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
   {
     typedef __deque_iterator<T, T&, T*, BufSiz>                 iterator;
     typedef __deque_iterator<T, const T&, const T*, BufSiz>     const_iterator;
-    static size_t buffer_size() { return __deque_buf_size(BufSiz, sizeof(T)); }
+    enum { buffer_shift = __deque_buf_shift<BufSiz, sizeof(T)>::value };
+    static size_t buffer_size() { return size_t(1) << buffer_shift; }
+    static size_t buffer_mask() { return buffer_size() - 1; }
 
     // 未继承 iterator 必须写五个必要的相应型别
-    typedef random_access_iterator_tag                          iterator_tag;
+    typedef random_access_iterator_tag                          iterator_category;
     typedef T                                                   value_type;
     typedef Ptr                                                 pointer;
     typedef Ref                                                 reference;
@@ -56,6 +82,10 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
     T* last; // 缓冲区的尾（含备用空间）
     map_pointer node; // 指向管控中心
 
+    __deque_iterator() : cur(0), first(0), last(0), node(0) { }
+    __deque_iterator(T* x, map_pointer y) : cur(x), first(*y), last(*y + buffer_size()), node(y) { }
+    __deque_iterator(const iterator& x) : cur(x.cur), first(x.first), last(x.last), node(x.node) { }
+
     // 转移缓冲区
     void set_node(map_pointer new_node)
     {
@@ -67,6 +97,7 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
     // 重载运算子
     reference operator*() const { return *cur; }
     pointer operator->() const { return &(operator*()); }
+    // buffer_size() 为编译期常数且为 2 的幂，乘法即为移位
     difference_type operator-(const self& x) const // 注意 self 是较大的 x 是较小的
     {
       return difference_type(buffer_size()) * (node - x.node) + (cur - first) - (x.cur - x.first);
@@ -95,7 +126,7 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
       --cur;
       return *this;
     }
-    self operator operator--(int)
+    self operator--(int)
     {
       self tmp = *this;
       --*this;
@@ -105,16 +136,17 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
     self& operator+=(difference_type n)
     {
       difference_type offset = n + (cur - first);
-      if (offset >= 0 && offset < difference_type(buffer_sizee()))
+      if (size_t(offset) < buffer_size()) // 负值转为 size_t 后必大于 buffer_size()
         // 目标在当前缓冲区
         cur += n;
       else {
         // 目标不在当前缓冲区
+        // 除以 buffer_size() 为右移，向负方向取整；余数为低位遮罩
         difference_type node_offset = offset > 0 ? \
-                                      offset / difference_type(buffer_size()) : \
-                                      -difference_type((-offset - 1) / buffer_size()) -1;
+                                      difference_type(size_t(offset) >> buffer_shift) : \
+                                      -difference_type(size_t(-offset - 1) >> buffer_shift) - 1;
         set_node(node + node_offset);
-        cur = first + (offset - node_offset + difference_type(buffer_size()));
+        cur = first + difference_type(size_t(offset) & buffer_mask());
       }
       return *this;
     }
@@ -123,7 +155,7 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
       self tmp = *this;
       return tmp += n;
     }
-    self operator-=(difference_type n) { return *this += -n; }
+    self& operator-=(difference_type n) { return *this += -n; }
     self operator-(difference_type n) const
     {
       self tmp = *this;
@@ -146,37 +178,55 @@ template <class T, class Ref, class Ptr, size_t BufSiz>
 
 
 // deque
-// 储存主体缓冲区默认值0，表示使用 512 bytes 缓冲区
+// 缓冲区大小的参数默认值0，表示使用 __DEQUE_BUF_BYTES 的缓冲区
 template <class T, class Alloc = alloc, size_t BufSiz = 0>
   class deque
   {
     public:
-    typedef T                                       value_type;
-    typedef value_type*                             pointer;
-    typedef size_t                                  size_type;
-    typedef __deque_iterator<T, T&, T*, BufSiz>     iterator;
+    typedef T                                               value_type;
+    typedef value_type*                                     pointer;
+    typedef const value_type*                               const_pointer;
+    typedef value_type&                                     reference;
+    typedef const value_type&                               const_reference;
+    typedef size_t                                          size_type;
+    typedef ptrdiff_t                                       difference_type;
+    typedef __deque_iterator<T, T&, T*, BufSiz>             iterator;
+    typedef __deque_iterator<T, const T&, const T*, BufSiz> const_iterator;
 
     protected:
     typedef pointer*                                map_pointer;
     static size_type initial_map_size() { return 8; }
+    static size_type buffer_size() { return iterator::buffer_size(); }
 
     protected:
     iterator start; // 第一个节点
     iterator finish; // 最后一个节点
     map_pointer map; // 指向 map，map是连续空间，其内元素都是指向缓冲区的指针
     size_type map_size; // map 可容纳指针数量
+    pointer spare[__DEQUE_SPARE_NODES]; // 暂存释放的缓冲区，下次配置时直接取用
+    size_type spare_count;
 
     public:
     iterator begin() { return start; }
+    const_iterator begin() const { return start; }
     iterator end() { return finish; }
+    const_iterator end() const { return finish; }
     reference operator[](size_type n) { return start[difference_type(n)]; }
+    const_reference operator[](size_type n) const { return start[difference_type(n)]; }
     reference front() { return *start; }
+    const_reference front() const { return *start; }
     reference back()
     {
       iterator tmp = finish;
       --tmp;
       return *tmp;
     }
+    const_reference back() const
+    {
+      iterator tmp = finish;
+      --tmp;
+      return *tmp;
+    }
     size_type size() const { return finish - start; }
     size_type max_size() const { return size_type(-1); }
     bool empty() const { return finish == start; }
@@ -186,19 +236,100 @@ template <class T, class Alloc = alloc, size_t BufSiz = 0>
     typedef simple_alloc<value_type, Alloc>     data_allocator;
     typedef simple_alloc<pointer, Alloc>        map_allocator;
 
+    public:
+    deque()
+    : start(), finish(), map(0), map_size(0), spare_count(0)
+    { create_map_and_nodes(0); }
+    deque(size_type n, const value_type& value)
+    : start(), finish(), map(0), map_size(0), spare_count(0)
+    { fill_initialize(n, value); }
     deque(int n, const value_type& value)
-    : start(), finish(), map(0), map_size(0)
+    : start(), finish(), map(0), map_size(0), spare_count(0)
+    { fill_initialize(n, value); }
+    deque(long n, const value_type& value)
+    : start(), finish(), map(0), map_size(0), spare_count(0)
     { fill_initialize(n, value); }
+    explicit deque(size_type n)
+    : start(), finish(), map(0), map_size(0), spare_count(0)
+    { fill_initialize(n, value_type()); }
+    deque(const deque& x)
+    : start(), finish(), map(0), map_size(0), spare_count(0)
+    { range_initialize(x.begin(), x.end(), random_access_iterator_tag()); }
+    // 以区间 [first, last) 初始化
+    template <class InputIterator>
+      deque(InputIterator first, InputIterator last)
+      : start(), finish(), map(0), map_size(0), spare_count(0)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        initialize_aux(first, last, integral());
+      }
+    ~deque()
+    {
+      tinystl::destroy(start, finish);
+      destroy_map_and_nodes();
+    }
 
-    pointer allocate_node() { return data_allocator::allocate(buffer_size())};
+    // 清空后整段附加，沿用原有的缓冲区
+    deque& operator=(const deque& x)
+    {
+      if (this != &x) {
+        clear();
+        append(x.begin(), x.end());
+      }
+      return *this;
+    }
+    void swap(deque& x)
+    {
+      iterator tmp = start; start = x.start; x.start = tmp;
+      tmp = finish; finish = x.finish; x.finish = tmp;
+      map_pointer m = map; map = x.map; x.map = m;
+      size_type n = map_size; map_size = x.map_size; x.map_size = n;
+      for (n = 0; n < size_type(__DEQUE_SPARE_NODES); ++n) {
+        pointer p = spare[n]; spare[n] = x.spare[n]; x.spare[n] = p;
+      }
+      n = spare_count; spare_count = x.spare_count; x.spare_count = n;
+    }
+
+    protected:
+    // 优先取用暂存的缓冲区
+    pointer allocate_node()
+    {
+      return spare_count != 0 ? \
+             spare[--spare_count] : \
+             data_allocator::allocate(buffer_size());
+    }
     void create_map_and_nodes(size_type num_elements); // 产生并安排 deque 结构
     void fill_initialize(size_type n, const value_type& value);
-
-    void deallocate_node(pointer p) { data_allocator::deallocate(p, buffer_size())};
+    // 区间初始化，整数型别视为 (n, value)
+    template <class Integer>
+      void initialize_aux(Integer n, Integer value, __true_type)
+      { fill_initialize(size_type(n), value_type(value)); }
+    template <class InputIterator>
+      void initialize_aux(InputIterator first, InputIterator last, __false_type)
+      { range_initialize(first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void range_initialize(InputIterator first, InputIterator last, input_iterator_tag);
+    template <class ForwardIterator>
+      void range_initialize(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+
+    // 暂存区未满时留下缓冲区，不归还配置器
+    void deallocate_node(pointer p)
+    {
+      if (spare_count < size_type(__DEQUE_SPARE_NODES))
+        spare[spare_count++] = p;
+      else
+        data_allocator::deallocate(p, buffer_size());
+    }
+    void release_spare_nodes()
+    {
+      while (spare_count != 0)
+        data_allocator::deallocate(spare[--spare_count], buffer_size());
+    }
     void destroy_map_and_nodes()
     {
       for (map_pointer cur = start.node; cur <= finish.node; ++cur)
-        deallocate_node(*cur);
+        data_allocator::deallocate(*cur, buffer_size());
+      release_spare_nodes();
       map_allocator::deallocate(map, map_size);
     }
 
@@ -213,15 +344,87 @@ template <class T, class Alloc = alloc, size_t BufSiz = 0>
     }
     void reserve_map_at_front(size_type nodes_to_add = 1)
     {
-      if (nodes_to_add > start.node - map)
+      if (nodes_to_add > size_type(start.node - map))
         // 如果 map 前端的节点备用空间不足
         reallocate_map(nodes_to_add, true);
     }
+    // 确保尾端 / 前端尚有 n 个元素的空间，传回新的 finish / start
+    // 所需的 map 节点一次备妥，最多只调用一次 reallocate_map()
+    iterator reserve_elements_at_back(size_type n)
+    {
+      size_type vacancies = (finish.last - finish.cur) - 1;
+      if (n > vacancies)
+        new_elements_at_back(n - vacancies);
+      return finish + difference_type(n);
+    }
+    iterator reserve_elements_at_front(size_type n)
+    {
+      size_type vacancies = start.cur - start.first;
+      if (n > vacancies)
+        new_elements_at_front(n - vacancies);
+      return start - difference_type(n);
+    }
+    void new_elements_at_back(size_type new_elements);
+    void new_elements_at_front(size_type new_elements);
+    // 归还 reserve_elements_at_xxx() 多配置而未使用的缓冲区
+    void destroy_nodes_at_back(iterator new_finish)
+    {
+      for (map_pointer n = finish.node + 1; n <= new_finish.node; ++n)
+        deallocate_node(*n);
+    }
+    void destroy_nodes_at_front(iterator new_start)
+    {
+      for (map_pointer n = new_start.node; n < start.node; ++n)
+        deallocate_node(*n);
+    }
+    // 将 first 起的 n 个元素复制到以 result 起始的未初始化空间
+    // 逐个缓冲区整段调用 uninitialized_copy()，来源为原生指针时可直接 memmove
+    template <class ForwardIterator>
+      void copy_to_buffers(ForwardIterator first, size_type n, iterator result);
+    // 来源也是 deque 时，两端都按缓冲区切段
+    template <class Ref, class Ptr>
+      void copy_to_buffers(__deque_iterator<T, Ref, Ptr, BufSiz> first, size_type n, iterator result);
+
     void push_back_aux(const value_type& t);
     void pop_back_aux();
     void push_front_aux(const value_type& t);
     void pop_front_aux();
     iterator insert_aux(iterator pos, const value_type& x);
+    template <class ForwardIterator>
+      void insert_aux(iterator pos, ForwardIterator first, ForwardIterator last, size_type n);
+
+    template <class InputIterator>
+      void append_aux(InputIterator first, InputIterator last, input_iterator_tag)
+      {
+        for ( ; first != last; ++first)
+          push_back(*first);
+      }
+    template <class ForwardIterator>
+      void append_aux(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+    // 无法事先得知个数，先收集于暂时的 deque
+    template <class InputIterator>
+      void prepend_aux(InputIterator first, InputIterator last, input_iterator_tag)
+      {
+        deque tmp(first, last);
+        prepend_aux(tmp.begin(), tmp.end(), random_access_iterator_tag());
+      }
+    template <class ForwardIterator>
+      void prepend_aux(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+
+    template <class Integer>
+      void insert_dispatch(iterator pos, Integer n, Integer value, __true_type)
+      { insert(pos, size_type(n), value_type(value)); }
+    template <class InputIterator>
+      void insert_dispatch(iterator pos, InputIterator first, InputIterator last, __false_type)
+      { range_insert(pos, first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void range_insert(iterator pos, InputIterator first, InputIterator last, input_iterator_tag)
+      {
+        deque tmp(first, last);
+        range_insert(pos, tmp.begin(), tmp.end(), random_access_iterator_tag());
+      }
+    template <class ForwardIterator>
+      void range_insert(iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag);
 
     public:
     void push_back(const value_type& t)
@@ -237,14 +440,14 @@ template <class T, class Alloc = alloc, size_t BufSiz = 0>
     {
       if (finish.cur != finish.first) {
         --finish.cur;
-        destroy(finish.cur);
+        tinystl::destroy(finish.cur);
       } else
         pop_back_aux(); // 缓冲区释放
     }
-    void push_front()(const value_type& t)
+    void push_front(const value_type& t)
     {
       if (start.cur != start.first) {
-        construct(strat.cur - 1, t);
+        construct(start.cur - 1, t);
         --start.cur;
       } else
         // 第一个缓冲区无备用空间时调用
@@ -253,22 +456,24 @@ template <class T, class Alloc = alloc, size_t BufSiz = 0>
     void pop_front()
     {
       if (start.cur != start.last - 1) {
-        destroy(start.cur);
+        tinystl::destroy(start.cur);
         ++start.cur;
       } else
         pop_front_aux();
     }
     void clear(); // 保留一个缓冲区
+    // 归还暂存的空闲缓冲区
+    void shrink_to_fit() { release_spare_nodes(); }
     iterator erase(iterator pos)
     {
       iterator next = pos;
       ++next;
       difference_type index = pos - start; // 清除点前的元素个数
-      if (index < (size() >> 1)) {
-        copy_backward(start, pos, next);
+      if (size_type(index) < (size() >> 1)) {
+        tinystl::copy_backward(start, pos, next);
         pop_front();
       } else {
-        copy(next, finish, pos);
+        tinystl::copy(next, finish, pos);
         pop_back();
       }
       return start + index;
@@ -288,6 +493,25 @@ template <class T, class Alloc = alloc, size_t BufSiz = 0>
         return insert_aux(position, x);
       }
     }
+    void insert(iterator position, size_type n, const value_type& x)
+    {
+      deque tmp(n, x);
+      range_insert(position, tmp.begin(), tmp.end(), random_access_iterator_tag());
+    }
+    // 将 [first, last) 插入 position 之前
+    template <class InputIterator>
+      void insert(iterator position, InputIterator first, InputIterator last)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        insert_dispatch(position, first, last, integral());
+      }
+    // 将 [first, last) 依原次序接于尾端 / 前端
+    template <class InputIterator>
+      void append(InputIterator first, InputIterator last)
+      { append_aux(first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void prepend(InputIterator first, InputIterator last)
+      { prepend_aux(first, last, iterator_category(first)); }
   };
 
 template <class T, class Alloc, size_t BufSize>
@@ -295,45 +519,121 @@ template <class T, class Alloc, size_t BufSize>
   {
     // 需要节点数 = (元素个数/缓冲区大小) + 1
     // 整除，会多配一个节点
-    size_type num_nodes = num_elements / buffer_size() + 1;
+    size_type num_nodes = (num_elements >> iterator::buffer_shift) + 1;
     // 一个 map 要管理几个节点，最少 8 个，最多是节点数加 2
     // （前后各预留一个，扩充时可用）
-    map_size = max(initial_map_size(), num_nodes + 2);
+    map_size = tinystl::max(initial_map_size(), num_nodes + 2);
     map = map_allocator::allocate(map_size);
 
     // 令 nstart 和 nfinish 指向 map 所有的全部节点中央
     // 使头尾两端可扩充区间一样大
     map_pointer nstart = map + (map_size - num_nodes) / 2;
     map_pointer nfinish = nstart + num_nodes - 1;
-    map_pointer cur;
+    map_pointer cur = nstart;
     try {
       // 为现用节点配置缓冲区
-      for (cur = nstart; cur <= finish; ++cur)
+      for ( ; cur <= nfinish; ++cur)
         *cur = allocate_node();
     } catch(...) {
       for (map_pointer n = nstart; n < cur; ++n)
-        deallocate_node(*n);
+        data_allocator::deallocate(*n, buffer_size());
       map_allocator::deallocate(map, map_size);
+      throw;
     }
     start.set_node(nstart);
     finish.set_node(nfinish);
     start.cur = start.first;
-    finish.cur = finish.first + num_elements % buffer_size();
+    finish.cur = finish.first + (num_elements & iterator::buffer_mask());
   }
 
 template <class T, class Alloc, size_t BufSize>
   void deque<T, Alloc, BufSize>::fill_initialize(size_type n, const value_type& value)
   {
     create_map_and_nodes(n);
-    map_pointer cur;
+    map_pointer cur = start.node;
     try {
-      for (cur = start.node; cur < finish.node; ++cur)
-        uninitialized_fill(*cur, *cur + buffer_size(), value);
-      uninitialized_fill(finish.first, finish.cur, value);
+      for ( ; cur < finish.node; ++cur)
+        tinystl::uninitialized_fill(*cur, *cur + buffer_size(), value);
+      tinystl::uninitialized_fill(finish.first, finish.cur, value);
     } catch(...) {
       for (map_pointer n = start.node; n < cur; ++n)
-        destroy(*n, *n + buffer_size());
+        tinystl::destroy(*n, *n + buffer_size());
       destroy_map_and_nodes();
+      throw;
+    }
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class InputIterator>
+  void deque<T, Alloc, BufSize>::range_initialize(InputIterator first, InputIterator last,
+                                                  input_iterator_tag)
+  {
+    create_map_and_nodes(0);
+    try {
+      for ( ; first != last; ++first)
+        push_back(*first);
+    } catch(...) {
+      tinystl::destroy(start, finish);
+      destroy_map_and_nodes();
+      throw;
+    }
+  }
+
+// 可事先得知元素个数，一次配置全部缓冲区
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::range_initialize(ForwardIterator first, ForwardIterator last,
+                                                  forward_iterator_tag)
+  {
+    size_type n = size_type(tinystl::distance(first, last));
+    create_map_and_nodes(n);
+    try {
+      copy_to_buffers(first, n, start);
+    } catch(...) {
+      destroy_map_and_nodes();
+      throw;
+    }
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::copy_to_buffers(ForwardIterator first, size_type n, iterator result)
+  {
+    iterator cur = result;
+    try {
+      while (n != 0) {
+        size_type len = tinystl::min(n, size_type(cur.last - cur.cur));
+        ForwardIterator mid = first;
+        tinystl::advance(mid, len);
+        tinystl::uninitialized_copy(first, mid, cur.cur);
+        first = mid;
+        cur += difference_type(len);
+        n -= len;
+      }
+    } catch(...) {
+      tinystl::destroy(result, cur);
+      throw;
+    }
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class Ref, class Ptr>
+  void deque<T, Alloc, BufSize>::copy_to_buffers(__deque_iterator<T, Ref, Ptr, BufSize> first, size_type n,
+                                                 iterator result)
+  {
+    iterator cur = result;
+    try {
+      while (n != 0) {
+        size_type len = tinystl::min(n, size_type(cur.last - cur.cur));
+        len = tinystl::min(len, size_type(first.last - first.cur));
+        tinystl::uninitialized_copy(first.cur, first.cur + len, cur.cur);
+        first += difference_type(len);
+        cur += difference_type(len);
+        n -= len;
+      }
+    } catch(...) {
+      tinystl::destroy(result, cur);
+      throw;
     }
   }
 
@@ -344,20 +644,21 @@ template <class T, class Alloc, size_t BufSize>
     size_type new_num_nodes = old_num_nodes + nodes_to_add;
     map_pointer new_nstart;
     if (map_size > 2 * new_num_nodes) {
+      // map 空间足够，只是偏向一端，将现用节点移至中央
       new_nstart = map + (map_size - new_num_nodes) / 2 + (add_at_front ? \
                                                            nodes_to_add : \
                                                            0);
       if (new_nstart < start.node)
-        copy(start.node, finish.node + 1, new_nstart);
+        tinystl::copy(start.node, finish.node + 1, new_nstart);
       else
-        copy_backward(start.node, finish.node + 1, new_nstart + old_num_nodes);
+        tinystl::copy_backward(start.node, finish.node + 1, new_nstart + old_num_nodes);
     } else {
-      size_type new_map_size = map_size + max(map_size, nodes_to_add) + 2;
+      size_type new_map_size = map_size + tinystl::max(map_size, nodes_to_add) + 2;
       map_pointer new_map = map_allocator::allocate(new_map_size);
-      new_start = new_map + (new_map_size - new_map_nodes) / 2 + (add_at_front ? \
-                                                                  nodes_to_add: \
-                                                                  0);
-      copy(start.node, finish.node + 1, new_nstart);
+      new_nstart = new_map + (new_map_size - new_num_nodes) / 2 + (add_at_front ? \
+                                                                   nodes_to_add: \
+                                                                   0);
+      tinystl::copy(start.node, finish.node + 1, new_nstart);
       map_allocator::deallocate(map, map_size);
       map = new_map;
       map_size = new_map_size;
@@ -366,6 +667,85 @@ template <class T, class Alloc, size_t BufSize>
     finish.set_node(new_nstart + old_num_nodes - 1);
   }
 
+template <class T, class Alloc, size_t BufSize>
+  void deque<T, Alloc, BufSize>::new_elements_at_back(size_type new_elements)
+  {
+    size_type new_nodes = (new_elements + buffer_size() - 1) >> iterator::buffer_shift;
+    reserve_map_at_back(new_nodes);
+    size_type i = 1;
+    try {
+      for ( ; i <= new_nodes; ++i)
+        *(finish.node + i) = allocate_node();
+    } catch(...) {
+      for (size_type j = 1; j < i; ++j)
+        deallocate_node(*(finish.node + j));
+      throw;
+    }
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  void deque<T, Alloc, BufSize>::new_elements_at_front(size_type new_elements)
+  {
+    size_type new_nodes = (new_elements + buffer_size() - 1) >> iterator::buffer_shift;
+    reserve_map_at_front(new_nodes);
+    size_type i = 1;
+    try {
+      for ( ; i <= new_nodes; ++i)
+        *(start.node - i) = allocate_node();
+    } catch(...) {
+      for (size_type j = 1; j < i; ++j)
+        deallocate_node(*(start.node - j));
+      throw;
+    }
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::append_aux(ForwardIterator first, ForwardIterator last,
+                                            forward_iterator_tag)
+  {
+    size_type n = size_type(tinystl::distance(first, last));
+    iterator new_finish = reserve_elements_at_back(n);
+    try {
+      copy_to_buffers(first, n, finish);
+    } catch(...) {
+      destroy_nodes_at_back(new_finish);
+      throw;
+    }
+    finish = new_finish;
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::prepend_aux(ForwardIterator first, ForwardIterator last,
+                                             forward_iterator_tag)
+  {
+    size_type n = size_type(tinystl::distance(first, last));
+    iterator new_start = reserve_elements_at_front(n);
+    try {
+      copy_to_buffers(first, n, new_start);
+    } catch(...) {
+      destroy_nodes_at_front(new_start);
+      throw;
+    }
+    start = new_start;
+  }
+
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::range_insert(iterator pos, ForwardIterator first, ForwardIterator last,
+                                              forward_iterator_tag)
+  {
+    if (pos.cur == start.cur)
+      prepend_aux(first, last, forward_iterator_tag());
+    else if (pos.cur == finish.cur)
+      append_aux(first, last, forward_iterator_tag());
+    else {
+      size_type n = size_type(tinystl::distance(first, last));
+      if (n != 0) insert_aux(pos, first, last, n);
+    }
+  }
+
 template <class T, class Alloc, size_t BufSize>
   void deque<T, Alloc, BufSize>::push_back_aux(const value_type& t)
   {
@@ -378,6 +758,7 @@ template <class T, class Alloc, size_t BufSize>
       finish.cur = finish.first;
     } catch(...) {
       deallocate_node(*(finish.node + 1));
+      throw;
     }
   }
 
@@ -387,7 +768,7 @@ template <class T, class Alloc, size_t BufSize>
     deallocate_node(finish.first);
     finish.set_node(finish.node - 1);
     finish.cur = finish.last - 1;
-    destroy(finish.cur);
+    tinystl::destroy(finish.cur);
   }
 
 template <class T, class Alloc, size_t BufSize>
@@ -411,7 +792,7 @@ template <class T, class Alloc, size_t BufSize>
 template <class T, class Alloc, size_t BufSize>
   void deque<T, Alloc, BufSize>::pop_front_aux()
   {
-    destroy(start.cur);
+    tinystl::destroy(start.cur);
     deallocate_node(start.first);
     start.set_node(start.node + 1);
     start.cur = start.first;
@@ -423,7 +804,7 @@ template <class T, class Alloc, size_t BufSize>
   {
     difference_type index = pos - start;
     value_type x_copy = x;
-    if (index < size() / 2) {
+    if (size_type(index) < size() / 2) {
       push_front(front());
       iterator front1 = start;
       ++front1;
@@ -432,7 +813,7 @@ template <class T, class Alloc, size_t BufSize>
       pos = start + index;
       iterator pos1 = pos;
       ++pos1;
-      copy(front2, pos1, front1);
+      tinystl::copy(front2, pos1, front1);
     } else {
       push_back(back());
       iterator back1 = finish;
@@ -440,25 +821,97 @@ template <class T, class Alloc, size_t BufSize>
       iterator back2 = back1;
       --back2;
       pos = start + index;
-      copy_backward(pos, back2, back1);
+      tinystl::copy_backward(pos, back2, back1);
     }
     *pos = x_copy;
     return pos;
   }
 
+// 与单一元素的 insert_aux() 相同，移动插入点前后较短的一侧
+// 异常发生时，start / finish 尚未更新的一侧归还新配置的缓冲区
+template <class T, class Alloc, size_t BufSize>
+  template <class ForwardIterator>
+  void deque<T, Alloc, BufSize>::insert_aux(iterator pos, ForwardIterator first, ForwardIterator last,
+                                            size_type n)
+  {
+    const difference_type elems_before = pos - start;
+    const size_type length = size();
+    if (size_type(elems_before) < length / 2) {
+      iterator new_start = reserve_elements_at_front(n);
+      iterator old_start = start;
+      pos = start + elems_before;
+      try {
+        if (elems_before >= difference_type(n)) {
+          // 前 n 个元素移入新空间，其余前移 n 格，再复制新元素
+          iterator start_n = start + difference_type(n);
+          copy_to_buffers(start, n, new_start);
+          start = new_start;
+          tinystl::copy(start_n, pos, old_start);
+          tinystl::copy(first, last, pos - difference_type(n));
+        } else {
+          // 原有元素与新元素的前段一起落在新空间
+          ForwardIterator mid = first;
+          tinystl::advance(mid, difference_type(n) - elems_before);
+          copy_to_buffers(start, size_type(elems_before), new_start);
+          try {
+            copy_to_buffers(first, n - size_type(elems_before), new_start + elems_before);
+          } catch(...) {
+            tinystl::destroy(new_start, new_start + elems_before);
+            throw;
+          }
+          start = new_start;
+          tinystl::copy(mid, last, old_start);
+        }
+      } catch(...) {
+        destroy_nodes_at_front(new_start);
+        throw;
+      }
+    } else {
+      iterator new_finish = reserve_elements_at_back(n);
+      iterator old_finish = finish;
+      const difference_type elems_after = difference_type(length) - elems_before;
+      pos = finish - elems_after;
+      try {
+        if (elems_after > difference_type(n)) {
+          iterator finish_n = finish - difference_type(n);
+          copy_to_buffers(finish_n, n, finish);
+          finish = new_finish;
+          tinystl::copy_backward(pos, finish_n, old_finish);
+          tinystl::copy(first, last, pos);
+        } else {
+          ForwardIterator mid = first;
+          tinystl::advance(mid, elems_after);
+          const size_type rest = n - size_type(elems_after);
+          copy_to_buffers(mid, rest, finish);
+          try {
+            copy_to_buffers(pos, size_type(elems_after), finish + difference_type(rest));
+          } catch(...) {
+            tinystl::destroy(finish, finish + difference_type(rest));
+            throw;
+          }
+          finish = new_finish;
+          tinystl::copy(first, mid, pos);
+        }
+      } catch(...) {
+        destroy_nodes_at_back(new_finish);
+        throw;
+      }
+    }
+  }
+
 template <class T, class Alloc, size_t BufSize>
   void deque<T, Alloc, BufSize>::clear()
   {
     for (map_pointer node = start.node + 1; node < finish.node; ++node) {
-      destroy(*node, *node + buffer_size());
-      data_allocator::deallocate(*node, buffer_size());
+      tinystl::destroy(*node, *node + buffer_size());
+      deallocate_node(*node);
     }
     if (start.node != finish.node) {
-      destroy(start.cur, start.last);
-      destroy(finish.first, finish.cur);
-      data_allocator::deallocate(finish.first, buffer_size());
+      tinystl::destroy(start.cur, start.last);
+      tinystl::destroy(finish.first, finish.cur);
+      deallocate_node(finish.first);
     } else
-      destroy(stary.cur, finish.cur);
+      tinystl::destroy(start.cur, finish.cur);
     finish = start;
   }
 
@@ -472,19 +925,19 @@ template <class T, class Alloc, size_t BufSize>
     } else {
       difference_type n = last - first;
       difference_type elems_before = first - start;
-      if (elems_before < (size() - n) / 2) {
-        copy_backward(start, first, last);
+      if (size_type(elems_before) < (size() - n) / 2) {
+        tinystl::copy_backward(start, first, last);
         iterator new_start = start + n;
-        destroy(start, new_start);
+        tinystl::destroy(start, new_start);
         for (map_pointer cur = start.node; cur < new_start.node; ++cur)
-          data_allocator::deallocate(*cur, buffer_size());
+          deallocate_node(*cur);
         start = new_start;
       } else {
-        copy(last, finish, first);
+        tinystl::copy(last, finish, first);
         iterator new_finish = finish - n;
-        destroy(new_finish, finish);
-        for (map_pointer cur = new_finish_node + 1; cur <= finish.node; ++cur)
-          data_allocator::deallocate(*cur, buffer_size());
+        tinystl::destroy(new_finish, finish);
+        for (map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur)
+          deallocate_node(*cur);
         finish = new_finish;
       }
       return start + elems_before;
@@ -494,4 +947,3 @@ template <class T, class Alloc, size_t BufSize>
 } // namespace tinystl
 
 #endif // !TINYSTL_DEQUE_H_
-
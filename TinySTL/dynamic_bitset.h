@@ -0,0 +1,394 @@
+
+/**
+ * dynamic_bitset
+ * 大小可在执行期改变的位集合，每个 bit 表示一个布尔值
+ * 以 unsigned long 为区块(block)，一次处理一整个 word
+ *
+ * 最后一个区块中超出 size() 的 bit 恒为 0，
+ * 因此 count() / find_first() 等操作无需额外处理尾端。
+ */
+#ifndef TINYSTL_DYNAMIC_BITSET_H_
+#define TINYSTL_DYNAMIC_BITSET_H_
+
+#include <limits.h> // for CHAR_BIT
+#include <string.h> // for memcpy() memset()
+#include "alloc.h"
+#include "algobase.h"
+
+namespace tinystl
+{
+
+typedef unsigned long __bitset_block;
+
+enum { __BITS_PER_BLOCK = sizeof(__bitset_block) * CHAR_BIT };
+
+// 区块中 1 的个数
+inline size_t __bitset_popcount(__bitset_block x)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountl(x); // 支持时编译为 popcnt 指令
+#else
+  size_t result = 0;
+  for ( ; x != 0; x &= x - 1) ++result;
+  return result;
+#endif
+}
+// 最低位的 1 的位置，x 不能为 0
+inline size_t __bitset_ctz(__bitset_block x)
+{
+#if defined(__GNUC__)
+  return __builtin_ctzl(x);
+#else
+  size_t result = 0;
+  for ( ; (x & 1) == 0; x >>= 1) ++result;
+  return result;
+#endif
+}
+
+template <class Alloc = alloc>
+  class dynamic_bitset
+  {
+    public:
+    typedef __bitset_block     block_type;
+    typedef size_t             size_type;
+    typedef bool               value_type;
+    typedef bool               const_reference;
+
+    static const size_type npos = size_type(-1);
+    static const size_type bits_per_block = __BITS_PER_BLOCK;
+
+    // 指向单个 bit 的代理对象
+    class reference
+    {
+      friend class dynamic_bitset;
+      block_type* block;
+      block_type mask;
+      reference(block_type* b, size_type pos) : block(b), mask(block_type(1) << pos) { }
+      public:
+      operator bool() const { return (*block & mask) != 0; }
+      bool operator~() const { return (*block & mask) == 0; }
+      reference& operator=(bool x)
+      {
+        if (x) *block |= mask;
+        else *block &= ~mask;
+        return *this;
+      }
+      reference& operator=(const reference& x) { return *this = bool(x); }
+      reference& flip() { *block ^= mask; return *this; }
+    };
+
+    protected:
+    typedef simple_alloc<block_type, Alloc> block_allocator;
+    block_type* blocks;    // 区块数组
+    size_type num_bits;    // bit 的个数
+    size_type block_cap;   // 已配置的区块个数
+
+    static size_type block_index(size_type pos) { return pos / bits_per_block; }
+    static size_type bit_index(size_type pos) { return pos % bits_per_block; }
+    static size_type blocks_for(size_type n) { return (n + bits_per_block - 1) / bits_per_block; }
+    // 区块内 [first, last) 的 bit 为 1 的遮罩，0 <= first < last <= bits_per_block
+    static block_type range_mask(size_type first, size_type last)
+    {
+      block_type high = last == bits_per_block ? \
+                        ~block_type(0) : \
+                        (block_type(1) << last) - 1;
+      return high & ~((block_type(1) << first) - 1);
+    }
+    // 将最后一个区块中超出 size() 的 bit 清为 0
+    void zero_unused_bits()
+    {
+      if (bit_index(num_bits) != 0)
+        blocks[num_blocks() - 1] &= range_mask(0, bit_index(num_bits));
+    }
+    void reserve_blocks(size_type n);
+    // 对 [first, last) 内每个区块施以 op(block, mask)
+    template <class BlockOp>
+      void range_apply(size_type first, size_type last, BlockOp op);
+
+    struct __set_op { void operator()(block_type& b, block_type m) const { b |= m; } };
+    struct __reset_op { void operator()(block_type& b, block_type m) const { b &= ~m; } };
+    struct __flip_op { void operator()(block_type& b, block_type m) const { b ^= m; } };
+
+    public:
+    // 构造与析构
+    dynamic_bitset() : blocks(0), num_bits(0), block_cap(0) { }
+    explicit dynamic_bitset(size_type n, bool value = false)
+    : blocks(0), num_bits(0), block_cap(0)
+    { resize(n, value); }
+    dynamic_bitset(const dynamic_bitset& x)
+    : blocks(0), num_bits(0), block_cap(0)
+    {
+      reserve_blocks(x.num_blocks());
+      if (x.num_blocks() != 0)
+        memcpy(blocks, x.blocks, x.num_blocks() * sizeof(block_type));
+      num_bits = x.num_bits;
+    }
+    ~dynamic_bitset() { block_allocator::deallocate(blocks, block_cap); }
+
+    dynamic_bitset& operator=(const dynamic_bitset& x)
+    {
+      if (this != &x) {
+        dynamic_bitset tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(dynamic_bitset& x)
+    {
+      block_type* tmp_blocks = blocks; blocks = x.blocks; x.blocks = tmp_blocks;
+      size_type tmp_bits = num_bits; num_bits = x.num_bits; x.num_bits = tmp_bits;
+      size_type tmp_cap = block_cap; block_cap = x.block_cap; x.block_cap = tmp_cap;
+    }
+
+    // 容量
+    size_type size() const { return num_bits; }
+    size_type num_blocks() const { return blocks_for(num_bits); }
+    size_type capacity() const { return block_cap * bits_per_block; }
+    bool empty() const { return num_bits == 0; }
+    void reserve(size_type n) { reserve_blocks(blocks_for(n)); }
+    void resize(size_type n, bool value = false);
+    void clear() { num_bits = 0; }
+    void push_back(bool value)
+    {
+      if (num_bits == capacity())
+        reserve_blocks(block_cap != 0 ? 2 * block_cap : 1);
+      size_type pos = num_bits++;
+      if (bit_index(pos) == 0) blocks[block_index(pos)] = 0;
+      if (value) blocks[block_index(pos)] |= block_type(1) << bit_index(pos);
+    }
+    void pop_back()
+    {
+      --num_bits;
+      zero_unused_bits();
+    }
+
+    // 区块存取，供外部以 word 为单位处理
+    block_type* data() { return blocks; }
+    const block_type* data() const { return blocks; }
+
+    // 单个 bit 的操作
+    bool test(size_type pos) const
+    { return (blocks[block_index(pos)] >> bit_index(pos)) & 1; }
+    bool operator[](size_type pos) const { return test(pos); }
+    reference operator[](size_type pos)
+    { return reference(blocks + block_index(pos), bit_index(pos)); }
+    dynamic_bitset& set(size_type pos, bool value = true)
+    {
+      reference(blocks + block_index(pos), bit_index(pos)) = value;
+      return *this;
+    }
+    dynamic_bitset& reset(size_type pos)
+    {
+      blocks[block_index(pos)] &= ~(block_type(1) << bit_index(pos));
+      return *this;
+    }
+    dynamic_bitset& flip(size_type pos)
+    {
+      blocks[block_index(pos)] ^= block_type(1) << bit_index(pos);
+      return *this;
+    }
+
+    // 区间 [first, last) 的操作，头尾区块以遮罩处理，中间区块整个 word 写入
+    // 另取名称，避免与 set(pos, value) 混淆
+    dynamic_bitset& set_range(size_type first, size_type last)
+    {
+      range_apply(first, last, __set_op());
+      return *this;
+    }
+    dynamic_bitset& reset_range(size_type first, size_type last)
+    {
+      range_apply(first, last, __reset_op());
+      return *this;
+    }
+    dynamic_bitset& flip_range(size_type first, size_type last)
+    {
+      range_apply(first, last, __flip_op());
+      return *this;
+    }
+
+    // 全体操作
+    dynamic_bitset& set()
+    {
+      if (num_blocks() != 0) memset(blocks, 0xff, num_blocks() * sizeof(block_type));
+      zero_unused_bits();
+      return *this;
+    }
+    dynamic_bitset& reset()
+    {
+      if (num_blocks() != 0) memset(blocks, 0, num_blocks() * sizeof(block_type));
+      return *this;
+    }
+    dynamic_bitset& flip()
+    {
+      for (size_type i = 0, n = num_blocks(); i < n; ++i)
+        blocks[i] = ~blocks[i];
+      zero_unused_bits();
+      return *this;
+    }
+
+    // 查询
+    size_type count() const
+    {
+      size_type result = 0;
+      for (size_type i = 0, n = num_blocks(); i < n; ++i)
+        result += __bitset_popcount(blocks[i]);
+      return result;
+    }
+    bool any() const
+    {
+      for (size_type i = 0, n = num_blocks(); i < n; ++i)
+        if (blocks[i] != 0) return true;
+      return false;
+    }
+    bool none() const { return !any(); }
+    bool all() const { return count() == size(); }
+
+    // 第一个为 1 的 bit，没有则传回 npos
+    size_type find_first() const { return find_from_block(0); }
+    // pos 之后第一个为 1 的 bit，没有则传回 npos
+    size_type find_next(size_type pos) const
+    {
+      ++pos;
+      if (pos >= num_bits) return npos;
+      size_type i = block_index(pos);
+      block_type rest = blocks[i] & ~((block_type(1) << bit_index(pos)) - 1);
+      if (rest != 0) return i * bits_per_block + __bitset_ctz(rest);
+      return find_from_block(i + 1);
+    }
+
+    // 集合运算，两者大小必须相同
+    // 以区块为单位的简单循环，编译器可将其向量化(vectorize)为 SIMD 指令
+    // x 可以是 *this 本身，因此不以 __restrict 修饰
+    dynamic_bitset& operator&=(const dynamic_bitset& x)
+    {
+      block_type* dst = blocks;
+      const block_type* src = x.blocks;
+      for (size_type i = 0, n = num_blocks(); i < n; ++i) dst[i] &= src[i];
+      return *this;
+    }
+    dynamic_bitset& operator|=(const dynamic_bitset& x)
+    {
+      block_type* dst = blocks;
+      const block_type* src = x.blocks;
+      for (size_type i = 0, n = num_blocks(); i < n; ++i) dst[i] |= src[i];
+      return *this;
+    }
+    dynamic_bitset& operator^=(const dynamic_bitset& x)
+    {
+      block_type* dst = blocks;
+      const block_type* src = x.blocks;
+      for (size_type i = 0, n = num_blocks(); i < n; ++i) dst[i] ^= src[i];
+      return *this;
+    }
+    // 差集：清除 x 中为 1 的 bit
+    dynamic_bitset& operator-=(const dynamic_bitset& x)
+    {
+      block_type* dst = blocks;
+      const block_type* src = x.blocks;
+      for (size_type i = 0, n = num_blocks(); i < n; ++i) dst[i] &= ~src[i];
+      return *this;
+    }
+    dynamic_bitset operator~() const
+    {
+      dynamic_bitset tmp(*this);
+      tmp.flip();
+      return tmp;
+    }
+
+    bool operator==(const dynamic_bitset& x) const
+    {
+      return num_bits == x.num_bits && \
+             (num_bits == 0 || memcmp(blocks, x.blocks, num_blocks() * sizeof(block_type)) == 0);
+    }
+    bool operator!=(const dynamic_bitset& x) const { return !(*this == x); }
+
+    protected:
+    size_type find_from_block(size_type i) const
+    {
+      for (size_type n = num_blocks(); i < n; ++i)
+        if (blocks[i] != 0)
+          return i * bits_per_block + __bitset_ctz(blocks[i]);
+      return npos;
+    }
+  };
+
+template <class Alloc>
+  const typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::npos;
+template <class Alloc>
+  const typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::bits_per_block;
+
+template <class Alloc>
+  void dynamic_bitset<Alloc>::reserve_blocks(size_type n)
+  {
+    if (n <= block_cap) return;
+    block_type* new_blocks = block_allocator::allocate(n);
+    if (num_blocks() != 0)
+      memcpy(new_blocks, blocks, num_blocks() * sizeof(block_type));
+    block_allocator::deallocate(blocks, block_cap);
+    blocks = new_blocks;
+    block_cap = n;
+  }
+
+template <class Alloc>
+  void dynamic_bitset<Alloc>::resize(size_type n, bool value)
+  {
+    size_type old_bits = num_bits;
+    size_type old_blocks = num_blocks();
+    if (n > old_bits) {
+      reserve_blocks(blocks_for(n));
+      // 新增的区块先清为 0，原最后一个区块的尾端本来就是 0
+      if (blocks_for(n) > old_blocks)
+        memset(blocks + old_blocks, 0, (blocks_for(n) - old_blocks) * sizeof(block_type));
+      num_bits = n;
+      if (value) set_range(old_bits, n);
+    } else {
+      num_bits = n;
+      zero_unused_bits();
+    }
+  }
+
+template <class Alloc>
+  template <class BlockOp>
+  void dynamic_bitset<Alloc>::range_apply(size_type first, size_type last, BlockOp op)
+  {
+    if (first >= last) return;
+    size_type first_block = block_index(first);
+    size_type last_block = block_index(last - 1);
+    if (first_block == last_block) {
+      op(blocks[first_block], range_mask(bit_index(first), bit_index(last - 1) + 1));
+      return;
+    }
+    op(blocks[first_block], range_mask(bit_index(first), bits_per_block));
+    for (size_type i = first_block + 1; i < last_block; ++i)
+      op(blocks[i], ~block_type(0));
+    op(blocks[last_block], range_mask(0, bit_index(last - 1) + 1));
+  }
+
+template <class Alloc>
+  inline dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc>& x, const dynamic_bitset<Alloc>& y)
+  {
+    dynamic_bitset<Alloc> result(x);
+    return result &= y;
+  }
+template <class Alloc>
+  inline dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc>& x, const dynamic_bitset<Alloc>& y)
+  {
+    dynamic_bitset<Alloc> result(x);
+    return result |= y;
+  }
+template <class Alloc>
+  inline dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc>& x, const dynamic_bitset<Alloc>& y)
+  {
+    dynamic_bitset<Alloc> result(x);
+    return result ^= y;
+  }
+template <class Alloc>
+  inline dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc>& x, const dynamic_bitset<Alloc>& y)
+  {
+    dynamic_bitset<Alloc> result(x);
+    return result -= y;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_DYNAMIC_BITSET_H_
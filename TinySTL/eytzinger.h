@@ -0,0 +1,255 @@
+
+/**
+ * eytzinger_index
+ * 静态的已排序索引，元素以 Eytzinger(BFS)次序存放：
+ * 节点 k 的子节点为 2k 与 2k+1，根为 1，就像 binary heap。
+ *
+ * 一般的二分搜寻在大表上每一步都是一次 cache miss，且分支无法预测。
+ * Eytzinger 次序下，搜寻路径的前几层集中在数组开头，常驻快取；
+ * 节点 k 往下四层的 16 个后代位于同一段连续空间，可以提前 prefetch。
+ * 搜寻循环每一步只有一次比较与一次移位，没有条件分支：
+ *
+ *   k = 1;
+ *   while (k <= n) k = 2 * k + (b[k] < x);
+ *   k >>= ctz(~k) + 1;   // 还原最后一次往左走的位置
+ *
+ * 建立后不可修改，适合读多写极少的大型查表。
+ */
+#ifndef TINYSTL_EYTZINGER_H_
+#define TINYSTL_EYTZINGER_H_
+
+#include "alloc.h"
+#include "algo.h"
+#include "vector.h"
+#include "iterator.h"
+#include "function.h"
+#include "construct.h"
+
+namespace tinystl
+{
+
+enum { __EYTZ_LINE = 64 }; // cache line 的大小
+
+// 2^k <= n 的最大 k，n 不能为 0
+inline size_t __eytz_log2(size_t n)
+{
+#if defined(__GNUC__)
+  return sizeof(size_t) * 8 - 1 - __builtin_clzl(n);
+#else
+  size_t k = 0;
+  while (n >>= 1) ++k;
+  return k;
+#endif
+}
+// 最低位连续的 1 的个数
+inline size_t __eytz_trailing_ones(size_t n)
+{
+#if defined(__GNUC__)
+  return ~n == 0 ? sizeof(size_t) * 8 : __builtin_ctzl(~n);
+#else
+  size_t k = 0;
+  for ( ; n & 1; n >>= 1) ++k;
+  return k;
+#endif
+}
+inline void __eytz_prefetch(const void* p)
+{
+#if defined(__GNUC__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+
+template <class T, class Compare = less<T>, class Alloc = alloc>
+  class eytzinger_index
+  {
+    public:
+    typedef T                 value_type;
+    typedef const T*          const_pointer;
+    typedef const T&          const_reference;
+    typedef size_t            size_type;
+
+    protected:
+    typedef simple_alloc<char, Alloc> data_allocator;
+
+    char* raw;        // 配置器交付的空间
+    size_type raw_size;
+    T* b;             // b[1..n]，b[0] 不使用；b 对齐至 cache line
+    size_type n;
+    size_type height; // 最后一层的深度，根为 0
+    Compare comp;
+
+    // 一条 cache line 可放的元素个数，prefetch 以此决定往下几层
+    static size_type line_elems()
+    { return sizeof(T) >= size_type(__EYTZ_LINE) ? 1 : size_type(__EYTZ_LINE) / sizeof(T); }
+
+    void allocate(size_type count)
+    {
+      n = count;
+      height = n == 0 ? 0 : __eytz_log2(n);
+      raw_size = (n + 1) * sizeof(T) + __EYTZ_LINE;
+      raw = data_allocator::allocate(raw_size);
+      b = (T*)(((size_t)raw + __EYTZ_LINE - 1) & ~size_t(__EYTZ_LINE - 1));
+    }
+    void deallocate()
+    {
+      if (raw) data_allocator::deallocate(raw, raw_size);
+    }
+    // 由已排序的区间依序构造 b[1..n]
+    template <class RandomAccessIterator>
+      void layout(RandomAccessIterator first);
+    // 搜寻结束时 k 已越过叶节点，去掉末尾往右走的步数与最后一次往左走
+    static size_type restore(size_type k) { return k >> (__eytz_trailing_ones(k) + 1); }
+
+    public:
+    // 由任意 Random Access 区间建立，未排序时先复制并排序
+    template <class RandomAccessIterator>
+      eytzinger_index(RandomAccessIterator first, RandomAccessIterator last,
+                      const Compare& c = Compare());
+    eytzinger_index(const eytzinger_index& x) : comp(x.comp)
+    {
+      allocate(x.n);
+      try {
+        tinystl::uninitialized_copy(x.b + 1, x.b + n + 1, b + 1);
+      } catch(...) {
+        deallocate();
+        throw;
+      }
+    }
+    ~eytzinger_index()
+    {
+      tinystl::destroy(b + 1, b + n + 1);
+      deallocate();
+    }
+    eytzinger_index& operator=(const eytzinger_index& x)
+    {
+      if (this != &x) {
+        eytzinger_index tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(eytzinger_index& x)
+    {
+      char* r = raw; raw = x.raw; x.raw = r;
+      T* p = b; b = x.b; x.b = p;
+      size_type s = raw_size; raw_size = x.raw_size; x.raw_size = s;
+      s = n; n = x.n; x.n = s;
+      s = height; height = x.height; x.height = s;
+      Compare c = comp; comp = x.comp; x.comp = c;
+    }
+
+    size_type size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    // Eytzinger 位置 k(1..n) 在排序后的次序(0..n-1)
+    // 以完全二叉树计算中序位置，再扣除最后一层缺少的节点
+    size_type order_of(size_type k) const
+    {
+      const size_type d = __eytz_log2(k);
+      const size_type p = k - (size_type(1) << d);
+      const size_type perfect = ((2 * p + 1) << (height - d)) - 1;
+      const size_type last_level = n - ((size_type(1) << height) - 1);
+      const size_type missing = (perfect + 1) / 2;
+      return missing > last_level ? perfect - (missing - last_level) : perfect;
+    }
+
+    // 第一个不小于 x 的元素的 Eytzinger 位置，不存在时为 0
+    size_type lower_bound_index(const T& x) const
+    {
+      const size_type line = line_elems();
+      size_type k = 1;
+      while (k <= n) {
+        __eytz_prefetch(b + k * line);
+        k = 2 * k + comp(b[k], x);
+      }
+      return restore(k);
+    }
+    // 第一个大于 x 的元素的 Eytzinger 位置，不存在时为 0
+    size_type upper_bound_index(const T& x) const
+    {
+      const size_type line = line_elems();
+      size_type k = 1;
+      while (k <= n) {
+        __eytz_prefetch(b + k * line);
+        k = 2 * k + !comp(x, b[k]);
+      }
+      return restore(k);
+    }
+
+    // 不小于 / 大于 x 的最小元素，不存在时为 0
+    const_pointer lower_bound(const T& x) const
+    {
+      size_type k = lower_bound_index(x);
+      return k ? b + k : 0;
+    }
+    const_pointer upper_bound(const T& x) const
+    {
+      size_type k = upper_bound_index(x);
+      return k ? b + k : 0;
+    }
+    bool contains(const T& x) const
+    {
+      size_type k = lower_bound_index(x);
+      return k != 0 && !comp(x, b[k]);
+    }
+    // 小于 x 的元素个数
+    size_type rank(const T& x) const
+    {
+      size_type k = lower_bound_index(x);
+      return k ? order_of(k) : n;
+    }
+    // 不大于 x 的元素个数
+    size_type upper_rank(const T& x) const
+    {
+      size_type k = upper_bound_index(x);
+      return k ? order_of(k) : n;
+    }
+    // 落在 [lo, hi) 的元素个数
+    size_type count_range(const T& lo, const T& hi) const
+    {
+      size_type r = rank(hi), l = rank(lo);
+      return r > l ? r - l : 0;
+    }
+  };
+
+template <class T, class Compare, class Alloc>
+  template <class RandomAccessIterator>
+  void eytzinger_index<T, Compare, Alloc>::layout(RandomAccessIterator first)
+  {
+    size_type k = 1;
+    try {
+      for ( ; k <= n; ++k)
+        construct(b + k, first[order_of(k)]);
+    } catch(...) {
+      tinystl::destroy(b + 1, b + k);
+      deallocate();
+      throw;
+    }
+  }
+
+template <class T, class Compare, class Alloc>
+  template <class RandomAccessIterator>
+  eytzinger_index<T, Compare, Alloc>::eytzinger_index(RandomAccessIterator first, RandomAccessIterator last,
+                                                      const Compare& c)
+  : comp(c)
+  {
+    bool sorted = true;
+    for (RandomAccessIterator i = first; sorted && i != last && i + 1 != last; ++i)
+      sorted = !comp(*(i + 1), *i);
+    if (sorted) {
+      allocate(size_type(last - first));
+      layout(first);
+    } else {
+      vector<T, Alloc> tmp(first, last);
+      tinystl::sort(tmp.begin(), tmp.end(), comp);
+      allocate(tmp.size());
+      layout(tmp.begin());
+    }
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_EYTZINGER_H_
@@ -0,0 +1,190 @@
+
+/**
+ * flat_map / flat_multimap
+ * 以 flat_tree 为底层结构的 map，value 为 pair<Key, T>。
+ *
+ * 与 map 不同，元素必须可被搬移，value_type 为 pair<Key, T> 而非 pair<const Key, T>，
+ * 使用端不可经由迭代器修改 first。
+ */
+#ifndef TINYSTL_FLAT_MAP_H_
+#define TINYSTL_FLAT_MAP_H_
+
+#include "alloc.h"
+#include "pair.h"
+#include "function.h"
+#include "flat_tree.h"
+
+namespace tinystl
+{
+
+// 以 pair 的 first 比较，供 value_comp() 传回
+template <class Key, class T, class Compare>
+  class __flat_map_value_compare : public binary_function<pair<Key, T>, pair<Key, T>, bool>
+  {
+    protected:
+    Compare comp;
+    public:
+    __flat_map_value_compare(const Compare& c) : comp(c) { }
+    bool operator()(const pair<Key, T>& x, const pair<Key, T>& y) const { return comp(x.first, y.first); }
+  };
+
+
+template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+  class flat_map
+  {
+    public:
+    typedef Key                                         key_type;
+    typedef T                                           data_type;
+    typedef T                                           mapped_type;
+    typedef pair<Key, T>                                value_type;
+    typedef Compare                                     key_compare;
+    typedef __flat_map_value_compare<Key, T, Compare>   value_compare;
+
+    private:
+    typedef flat_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+    rep_type t;
+
+    public:
+    typedef typename rep_type::pointer            pointer;
+    typedef typename rep_type::iterator           iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::reference          reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    // 构造
+    flat_map() : t(Compare()) { }
+    explicit flat_map(const Compare& comp) : t(comp) { }
+    // 由未排序的区间构造，键值重复时保留第一个
+    template <class InputIterator>
+      flat_map(InputIterator first, InputIterator last) : t(Compare())
+      { t.insert_unique(first, last); }
+    template <class InputIterator>
+      flat_map(InputIterator first, InputIterator last, const Compare& comp) : t(comp)
+      { t.insert_unique(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return value_compare(t.key_comp()); }
+    iterator begin() { return t.begin(); }
+    const_iterator begin() const { return t.begin(); }
+    iterator end() { return t.end(); }
+    const_iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    size_type capacity() const { return t.capacity(); }
+    void reserve(size_type n) { t.reserve(n); }
+    void shrink_to_fit() { t.shrink_to_fit(); }
+    void swap(flat_map& x) { t.swap(x.t); }
+    // 键值不存在时插入 T()，以搜寻得到的位置作为提示
+    T& operator[](const key_type& k)
+    {
+      iterator i = t.lower_bound(k);
+      if (i == end() || key_comp()(k, i->first))
+        i = t.insert_unique(i, value_type(k, T()));
+      return i->second;
+    }
+
+    // 插入、删除
+    pair<iterator, bool> insert(const value_type& x) { return t.insert_unique(x); }
+    iterator insert(const_iterator position, const value_type& x) { return t.insert_unique(position, x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+    iterator erase(const_iterator position) { return t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    iterator erase(const_iterator first, const_iterator last) { return t.erase(first, last); }
+    void clear() { t.clear(); }
+
+    // 搜寻
+    iterator find(const key_type& x) { return t.find(x); }
+    const_iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+    const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+    const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+    pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+  };
+
+
+/**
+ * flat_multimap
+ * 键值可重复，逐一插入时等价元素依插入次序排列
+ */
+template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+  class flat_multimap
+  {
+    public:
+    typedef Key                                         key_type;
+    typedef T                                           data_type;
+    typedef T                                           mapped_type;
+    typedef pair<Key, T>                                value_type;
+    typedef Compare                                     key_compare;
+    typedef __flat_map_value_compare<Key, T, Compare>   value_compare;
+
+    private:
+    typedef flat_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc> rep_type;
+    rep_type t;
+
+    public:
+    typedef typename rep_type::pointer            pointer;
+    typedef typename rep_type::iterator           iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::reference          reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    // 构造
+    flat_multimap() : t(Compare()) { }
+    explicit flat_multimap(const Compare& comp) : t(comp) { }
+    template <class InputIterator>
+      flat_multimap(InputIterator first, InputIterator last) : t(Compare())
+      { t.insert_equal(first, last); }
+    template <class InputIterator>
+      flat_multimap(InputIterator first, InputIterator last, const Compare& comp) : t(comp)
+      { t.insert_equal(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return value_compare(t.key_comp()); }
+    iterator begin() { return t.begin(); }
+    const_iterator begin() const { return t.begin(); }
+    iterator end() { return t.end(); }
+    const_iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    size_type capacity() const { return t.capacity(); }
+    void reserve(size_type n) { t.reserve(n); }
+    void shrink_to_fit() { t.shrink_to_fit(); }
+    void swap(flat_multimap& x) { t.swap(x.t); }
+
+    // 插入、删除
+    iterator insert(const value_type& x) { return t.insert_equal(x); }
+    iterator insert(const_iterator position, const value_type& x) { return t.insert_equal(position, x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_equal(first, last); }
+    iterator erase(const_iterator position) { return t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    iterator erase(const_iterator first, const_iterator last) { return t.erase(first, last); }
+    void clear() { t.clear(); }
+
+    // 搜寻
+    iterator find(const key_type& x) { return t.find(x); }
+    const_iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+    const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+    const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    pair<iterator, iterator> equal_range(const key_type& x) { return t.equal_range(x); }
+    pair<const_iterator, const_iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_MAP_H_
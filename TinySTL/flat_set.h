@@ -0,0 +1,88 @@
+
+/**
+ * flat_set
+ * 以 flat_tree 为底层结构的 set，value 即为 key，键值不重复。
+ * 元素不可经由迭代器修改，iterator 与 const_iterator 相同。
+ *
+ * 由未排序的区间构造时，一次排序并去除重复，比逐一插入快得多。
+ */
+#ifndef TINYSTL_FLAT_SET_H_
+#define TINYSTL_FLAT_SET_H_
+
+#include "alloc.h"
+#include "pair.h"
+#include "function.h"
+#include "flat_tree.h"
+
+namespace tinystl
+{
+
+template <class Key, class Compare = less<Key>, class Alloc = alloc>
+  class flat_set
+  {
+    public:
+    typedef Key            key_type;
+    typedef Key            value_type;
+    typedef Compare        key_compare;
+    typedef Compare        value_compare;
+
+    private:
+    typedef flat_tree<key_type, value_type, identity<value_type>, key_compare, Alloc> rep_type;
+    rep_type t;
+
+    public:
+    typedef typename rep_type::const_iterator     iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::const_reference    reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    // 构造
+    flat_set() : t(Compare()) { }
+    explicit flat_set(const Compare& comp) : t(comp) { }
+    template <class InputIterator>
+      flat_set(InputIterator first, InputIterator last) : t(Compare())
+      { t.insert_unique(first, last); }
+    template <class InputIterator>
+      flat_set(InputIterator first, InputIterator last, const Compare& comp) : t(comp)
+      { t.insert_unique(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return t.key_comp(); }
+    iterator begin() const { return t.begin(); }
+    iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    size_type capacity() const { return t.capacity(); }
+    void reserve(size_type n) { t.reserve(n); }
+    void shrink_to_fit() { t.shrink_to_fit(); }
+    void swap(flat_set& x) { t.swap(x.t); }
+
+    // 插入、删除
+    pair<iterator, bool> insert(const value_type& x)
+    {
+      pair<typename rep_type::iterator, bool> p = t.insert_unique(x);
+      return pair<iterator, bool>(p.first, p.second);
+    }
+    iterator insert(iterator position, const value_type& x) { return t.insert_unique(position, x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+    iterator erase(iterator position) { return t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    iterator erase(iterator first, iterator last) { return t.erase(first, last); }
+    void clear() { t.clear(); }
+
+    // 搜寻
+    iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_SET_H_
@@ -0,0 +1,245 @@
+
+/**
+ * flat_tree
+ * 以已排序的 vector 实作的关联式容器，为 flat_set / flat_map 的底层结构。
+ * 介面与 rb_tree 相同(insert_unique / insert_equal / key_comp ...)，
+ * 使用端可在 flat_map 与以 rb_tree 实作的 map 之间直接切换。
+ *
+ * 与 rb_tree 相比：
+ *   元素连续存放，没有每个节点三个指针加颜色的额外空间，走访与搜寻都对快取友善
+ *   搜寻为 O(log n) 的二分搜寻(无分支版本，见 algo.h)
+ *   单一元素的插入、删除为 O(n)，适合读多写少的查表
+ *   区间插入先排序新元素再与原有元素合并，为 O(n + m log m)
+ * 插入、删除会使所有迭代器失效。
+ */
+#ifndef TINYSTL_FLAT_TREE_H_
+#define TINYSTL_FLAT_TREE_H_
+
+#include "alloc.h"
+#include "algo.h"
+#include "pair.h"
+#include "vector.h"
+#include "algobase.h"
+
+namespace tinystl
+{
+
+// 以键值比较两个 value
+template <class Value, class KeyOfValue, class Compare>
+  struct __flat_value_compare
+  {
+    Compare comp;
+    __flat_value_compare(const Compare& c) : comp(c) { }
+    bool operator()(const Value& x, const Value& y) const { return comp(KeyOfValue()(x), KeyOfValue()(y)); }
+  };
+
+// 已排序区间中相邻的两个 value 是否等价
+template <class Value, class KeyOfValue, class Compare>
+  struct __flat_value_equiv
+  {
+    Compare comp;
+    __flat_value_equiv(const Compare& c) : comp(c) { }
+    bool operator()(const Value& x, const Value& y) const { return !comp(KeyOfValue()(x), KeyOfValue()(y)); }
+  };
+
+// 供 lower_bound() 以 key 搜寻 value 的区间，两个方向分开定义，以免 Key 与 Value 相同时重载冲突
+template <class Key, class Value, class KeyOfValue, class Compare>
+  struct __flat_value_less_key
+  {
+    Compare comp;
+    __flat_value_less_key(const Compare& c) : comp(c) { }
+    bool operator()(const Value& x, const Key& k) const { return comp(KeyOfValue()(x), k); }
+  };
+template <class Key, class Value, class KeyOfValue, class Compare>
+  struct __flat_key_less_value
+  {
+    Compare comp;
+    __flat_key_less_value(const Compare& c) : comp(c) { }
+    bool operator()(const Key& k, const Value& x) const { return comp(k, KeyOfValue()(x)); }
+  };
+
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc>
+  class flat_tree
+  {
+    public:
+    typedef Key                                          key_type;
+    typedef Value                                        value_type;
+    typedef vector<Value, Alloc>                         container_type;
+    typedef typename container_type::pointer             pointer;
+    typedef typename container_type::iterator            iterator;
+    typedef typename container_type::const_iterator      const_iterator;
+    typedef typename container_type::reference           reference;
+    typedef typename container_type::const_reference     const_reference;
+    typedef size_t                                       size_type;
+    typedef ptrdiff_t                                    difference_type;
+
+    protected:
+    typedef __flat_value_compare<Value, KeyOfValue, Compare>          value_compare;
+    typedef __flat_value_equiv<Value, KeyOfValue, Compare>            value_equiv;
+    typedef __flat_value_less_key<Key, Value, KeyOfValue, Compare>    value_less_key;
+    typedef __flat_key_less_value<Key, Value, KeyOfValue, Compare>    key_less_value;
+
+    container_type c;
+    Compare key_compare;
+
+    static const Key& key(const Value& x) { return KeyOfValue()(x); }
+    iterator to_iterator(const_iterator i) { return c.begin() + (i - c.begin()); }
+    // 排序 [c.begin() + n, c.end()) 并与前 n 个元素合并
+    void merge_tail(size_type n, bool unique);
+
+    public:
+    flat_tree(const Compare& comp = Compare()) : key_compare(comp) { }
+
+    Compare key_comp() const { return key_compare; }
+    iterator begin() { return c.begin(); }
+    const_iterator begin() const { return c.begin(); }
+    iterator end() { return c.end(); }
+    const_iterator end() const { return c.end(); }
+    bool empty() const { return c.empty(); }
+    size_type size() const { return c.size(); }
+    size_type max_size() const { return size_type(-1) / sizeof(Value); }
+    size_type capacity() const { return c.capacity(); }
+    void reserve(size_type n) { c.reserve(n); }
+    void shrink_to_fit() { c.shrink_to_fit(); }
+    void swap(flat_tree& x)
+    {
+      c.swap(x.c);
+      Compare tmp = key_compare;
+      key_compare = x.key_compare;
+      x.key_compare = tmp;
+    }
+
+    // 插入
+    // 将 x 插入，保持键值独一无二
+    pair<iterator, bool> insert_unique(const value_type& x);
+    // 将 x 插入，允许键值重复，置于等价元素之后
+    iterator insert_equal(const value_type& x)
+    {
+      return c.insert(to_iterator(upper_bound(key(x))), x);
+    }
+    // position 为插入位置的提示，正确时不需搜寻，依序插入已排序的数据只需 O(1)
+    iterator insert_unique(const_iterator position, const value_type& x);
+    iterator insert_equal(const_iterator position, const value_type& x);
+    // 区间插入：附加于尾端后排序、合并
+    template <class InputIterator>
+      void insert_unique(InputIterator first, InputIterator last)
+      {
+        const size_type n = size();
+        c.append_range(first, last);
+        merge_tail(n, true);
+      }
+    template <class InputIterator>
+      void insert_equal(InputIterator first, InputIterator last)
+      {
+        const size_type n = size();
+        c.append_range(first, last);
+        merge_tail(n, false);
+      }
+
+    // 删除
+    iterator erase(const_iterator position) { return c.erase(to_iterator(position)); }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+      return c.erase(to_iterator(first), to_iterator(last));
+    }
+    size_type erase(const key_type& k)
+    {
+      pair<iterator, iterator> p = equal_range(k);
+      const size_type n = size_type(p.second - p.first);
+      c.erase(p.first, p.second);
+      return n;
+    }
+    void clear() { c.clear(); }
+
+    // 搜寻
+    iterator lower_bound(const key_type& k)
+    { return tinystl::lower_bound(c.begin(), c.end(), k, value_less_key(key_compare)); }
+    const_iterator lower_bound(const key_type& k) const
+    { return tinystl::lower_bound(c.begin(), c.end(), k, value_less_key(key_compare)); }
+    iterator upper_bound(const key_type& k)
+    { return tinystl::upper_bound(c.begin(), c.end(), k, key_less_value(key_compare)); }
+    const_iterator upper_bound(const key_type& k) const
+    { return tinystl::upper_bound(c.begin(), c.end(), k, key_less_value(key_compare)); }
+    pair<iterator, iterator> equal_range(const key_type& k)
+    { return pair<iterator, iterator>(lower_bound(k), upper_bound(k)); }
+    pair<const_iterator, const_iterator> equal_range(const key_type& k) const
+    { return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k)); }
+    iterator find(const key_type& k)
+    {
+      iterator i = lower_bound(k);
+      return i == end() || key_compare(k, key(*i)) ? end() : i;
+    }
+    const_iterator find(const key_type& k) const
+    {
+      const_iterator i = lower_bound(k);
+      return i == end() || key_compare(k, key(*i)) ? end() : i;
+    }
+    size_type count(const key_type& k) const
+    {
+      pair<const_iterator, const_iterator> p = equal_range(k);
+      return size_type(p.second - p.first);
+    }
+  };
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+  pair<typename flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator, bool>
+  flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const value_type& x)
+  {
+    iterator i = lower_bound(key(x));
+    if (i != end() && !key_compare(key(x), key(*i))) // 已存在
+      return pair<iterator, bool>(i, false);
+    return pair<iterator, bool>(c.insert(i, x), true);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+  typename flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+  flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_unique(const_iterator position, const value_type& x)
+  {
+    // 提示正确：前一个元素小于 x，且 x 小于 position 所指元素
+    if ((position == end() || key_compare(key(x), key(*position))) &&
+        (position == begin() || key_compare(key(*(position - 1)), key(x))))
+      return c.insert(to_iterator(position), x);
+    return insert_unique(x).first;
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+  typename flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::iterator
+  flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::insert_equal(const_iterator position, const value_type& x)
+  {
+    if ((position == end() || !key_compare(key(*position), key(x))) &&
+        (position == begin() || !key_compare(key(x), key(*(position - 1)))))
+      return c.insert(to_iterator(position), x);
+    return insert_equal(x);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc>
+  void flat_tree<Key, Value, KeyOfValue, Compare, Alloc>::merge_tail(size_type n, bool unique)
+  {
+    value_compare comp(key_compare);
+    value_equiv equiv(key_compare);
+    // 稳定排序：等价的新元素维持输入的先后，unique 保留的便是第一个
+    if (c.size() - n > size_type(__stl_chunk_size)) {
+      container_type buf(c.begin() + n, c.end());
+      tinystl::__merge_sort_with_buffer(c.begin() + n, c.end(), buf.begin(), comp);
+    } else
+      tinystl::__insertion_sort(c.begin() + n, c.end(), comp);
+    if (unique) // 新元素之间先去除重复，减少合并的数量
+      c.erase(tinystl::unique(c.begin() + n, c.end(), equiv), c.end());
+    iterator mid = c.begin() + n;
+    bool merged = false;
+    // 新元素全部不小于原有元素时(例如依序附加)，不需合并
+    if (mid != c.begin() && mid != c.end() && comp(*mid, *(mid - 1))) {
+      container_type buf(mid, c.end()); // 只暂存新元素，由尾端往前合并
+      tinystl::__merge_backward(c.begin(), mid, buf.begin(), buf.end(), c.end(), comp);
+      merged = true;
+    }
+    if (unique) { // 等价元素中，原有的排在前面而被保留
+      iterator from = merged || n == 0 ? c.begin() : c.begin() + (n - 1);
+      c.erase(tinystl::unique(from, c.end(), equiv), c.end());
+    }
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_FLAT_TREE_H_
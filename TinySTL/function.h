@@ -1,10 +1,72 @@
+
+/**
+ * 仿函数(functor / function object)
+ * 供容器与算法作为比较准则，或由 value 取出 key
+ */
 #ifndef TINYSTL_FUNCTION_H_
 #define TINYSTL_FUNCTION_H_
 
 namespace tinystl
 {
 
+// 仿函数的相应型别，供配接器(adapter)取用
+template <class Arg, class Result>
+  struct unary_function
+  {
+    typedef Arg         argument_type;
+    typedef Result      result_type;
+  };
+
+template <class Arg1, class Arg2, class Result>
+  struct binary_function
+  {
+    typedef Arg1        first_argument_type;
+    typedef Arg2        second_argument_type;
+    typedef Result      result_type;
+  };
+
+
+// 关系运算
+template <class T>
+  struct equal_to : public binary_function<T, T, bool>
+  {
+    bool operator()(const T& x, const T& y) const { return x == y; }
+  };
+
+template <class T>
+  struct less : public binary_function<T, T, bool>
+  {
+    bool operator()(const T& x, const T& y) const { return x < y; }
+  };
+
+template <class T>
+  struct greater : public binary_function<T, T, bool>
+  {
+    bool operator()(const T& x, const T& y) const { return y < x; }
+  };
+
+
+// 证同(identity)与选择(selection)，用作关联式容器的 KeyOfValue
+// set 的 value 即为 key
+template <class T>
+  struct identity : public unary_function<T, T>
+  {
+    const T& operator()(const T& x) const { return x; }
+  };
+
+// map 的 value 为 pair，key 为其第一元素
+template <class Pair>
+  struct select1st : public unary_function<Pair, typename Pair::first_type>
+  {
+    const typename Pair::first_type& operator()(const Pair& x) const { return x.first; }
+  };
+
+template <class Pair>
+  struct select2nd : public unary_function<Pair, typename Pair::second_type>
+  {
+    const typename Pair::second_type& operator()(const Pair& x) const { return x.second; }
+  };
+
 } // namespace tinystl
 
 #endif // !TINYSTL_FUNCTION_H_
-
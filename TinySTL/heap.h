@@ -28,11 +28,11 @@ template <class RandomAccessIterator, class Distance, class T>
 
 template <class RandomAccessIterator, class Distance, class T>
   inline void __push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Distance*, T*)
-  { __push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1))); }
+  { tinystl::__push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1))); }
 
 template <class RandomAccessIterator>
-  inline void __push_heap_aux(RandomAccessIterator first, RandomAccessIterator last)
-  { __puah_heap_aux(first, last, distance_type(first), value_type(first)); }
+  inline void push_heap(RandomAccessIterator first, RandomAccessIterator last)
+  { tinystl::__push_heap_aux(first, last, distance_type(first), value_type(first)); }
 
 
 template <class RandomAccessIterator, class Distance, class T>
@@ -51,7 +51,7 @@ template <class RandomAccessIterator, class Distance, class T>
       *(first + holeIndex) = *(first + (secondChild - 1));
       holeIndex = secondChild - 1;
     }
-    __push_heap(first, holeIndex, topIndex, value);
+    tinystl::__push_heap(first, holeIndex, topIndex, value);
   }
 
 
@@ -59,16 +59,16 @@ template <class RandomAccessIterator, class T, class Distance>
   inline void __pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result, T value, Distance*)
   {
     *result = *first;
-    __adjust_heap(first, Distance(0), Distance(last - first), value);
+    tinystl::__adjust_heap(first, Distance(0), Distance(last - first), value);
   }
 
 template <class RandomAccessIterator, class T>
   inline void __pop_heap_aux(RandomAccessIterator first, RandomAccessIterator  last, T*)
-  { __pop_heap(first, last - 1, last - 1, T(*(last - 1)), distance_type(first)); }
+  { tinystl::__pop_heap(first, last - 1, last - 1, T(*(last - 1)), distance_type(first)); }
 
 template <class RandomAccessIterator>
   inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last)
-  { __pop_heap_aux(first, last, value_type(first)); }
+  { tinystl::__pop_heap_aux(first, last, value_type(first)); }
 
 
 template <class RandomAccessIterator, class T, class Distance>
@@ -78,7 +78,7 @@ template <class RandomAccessIterator, class T, class Distance>
     Distance len = last - first;
     Distance parent = (len - 2) / 2;
     while (true) {
-      __adjust_heap(first, parent, len, T(*(first + parent)));
+      tinystl::__adjust_heap(first, parent, len, T(*(first + parent)));
       if (parent == 0) return;
       --parent;
     }
@@ -86,14 +86,14 @@ template <class RandomAccessIterator, class T, class Distance>
 
 template <class RandomAccessIterator>
   inline void make_heap(RandomAccessIterator first, RandomAccessIterator last)
-  { __make_heap(first, last, value_type(first), distance_type(first)); }
+  { tinystl::__make_heap(first, last, value_type(first), distance_type(first)); }
 
 
 template <class RandomAccessIterator>
   void sort_heap(RandomAccessIterator first, RandomAccessIterator last)
   {
     while (last - first > 1)
-      pop_heap(first, last--);
+      tinystl::pop_heap(first, last--);
   }
 
 
@@ -103,7 +103,7 @@ template <class RandomAccessIterator, class Distance, class T, class Compare>
   void __push_heap(RandomAccessIterator first, Distance holeIndex, Distance topIndex, T value, Compare comp)
   {
     Distance parent = (holeIndex - 1) / 2;
-    while (hole > topIndex && comp((*first + parent), value)) {
+    while (holeIndex > topIndex && comp(*(first + parent), value)) {
       *(first + holeIndex) = *(first + parent);
       holeIndex = parent;
       parent = (holeIndex - 1) / 2;
@@ -113,11 +113,11 @@ template <class RandomAccessIterator, class Distance, class T, class Compare>
 
 template <class RandomAccessIterator, class Distance, class T, class Compare>
   inline void __push_heap_aux(RandomAccessIterator first, RandomAccessIterator last, Compare comp, Distance*, T*)
-  { __push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)), comp); }
+  { tinystl::__push_heap(first, Distance((last - first) - 1), Distance(0), T(*(last - 1)), comp); }
 
 template <class RandomAccessIterator, class Compare>
   inline void push_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
-  { __push_heap_aux(first, last, comp, distance_type(first), value_type(first)); }
+  { tinystl::__push_heap_aux(first, last, comp, distance_type(first), value_type(first)); }
 
 
 template <class RandomAccessIterator, class Distance, class T, class Compare>
@@ -136,7 +136,7 @@ template <class RandomAccessIterator, class Distance, class T, class Compare>
       *(first + holeIndex) = *(first + (secondChild - 1));
       holeIndex = secondChild - 1;
     }
-    _push_heap(first, holeIndex, topIndex, value, comp);
+    tinystl::__push_heap(first, holeIndex, topIndex, value, comp);
   }
 
 
@@ -144,16 +144,16 @@ template <class RandomAccessIterator, class T, class Distance, class Compare>
   inline void __pop_heap(RandomAccessIterator first, RandomAccessIterator last, RandomAccessIterator result, T value, Compare comp, Distance*)
   {
     *result = *first;
-    __adjust_heap(first, Distance(0), Distance(last - first), value, comp);
+    tinystl::__adjust_heap(first, Distance(0), Distance(last - first), value, comp);
   }
 
 template <class RandomAccessIterator, class T, class Compare>
   inline void __pop_heap_aux(RandomAccessIterator first, RandomAccessIterator last, T*, Compare comp)
-  { __pop_heap(first, last - 1, last - 1, T(*(last - 1)), comp, distance_type(first)); }
+  { tinystl::__pop_heap(first, last - 1, last - 1, T(*(last - 1)), comp, distance_type(first)); }
 
 template <class RandomAccessIterator, class Compare>
   inline void pop_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
-  { __pop_heap_aux(first, last, value_type(first), comp); }
+  { tinystl::__pop_heap_aux(first, last, value_type(first), comp); }
 
 
 template <class RandomAccessIterator, class Compare, class T, class Distance>
@@ -163,22 +163,22 @@ template <class RandomAccessIterator, class Compare, class T, class Distance>
     Distance len = last - first;
     Distance parent = (len - 2) / 2;
     while (true) {
-      __adjust_heap(first, parent, len, T(*(first + parent)), comp);
-      if (oarent == 0) return;
+      tinystl::__adjust_heap(first, parent, len, T(*(first + parent)), comp);
+      if (parent == 0) return;
       --parent;
     }
   }
 
 template <class RandomAccessIterator, class Compare>
   inline void make_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
-  { __make_heap(first, last, comp, value_type(first), distance_type(first)); }
+  { tinystl::__make_heap(first, last, comp, value_type(first), distance_type(first)); }
 
 
 template <class RandomAccessIterator, class Compare>
   void sort_heap(RandomAccessIterator first, RandomAccessIterator last, Compare comp)
   {
     while (last - first > 1)
-      pop_heap(first, last--, comp);
+      tinystl::pop_heap(first, last--, comp);
   }
 
 } // namespace tinystl
@@ -0,0 +1,308 @@
+
+/**
+ * ilist
+ * 侵入式(intrusive)双向链表：链接用的指针(hook)嵌入在元素本身，
+ * 容器不配置节点、不复制元素，只把使用者已经建立的物件串接起来。
+ * 适合物件已由 pool 管理，只需在几个队列之间移动的场合。
+ *
+ * 元素以继承 ilist_hook(配合 ibase_hook)或含有 ilist_hook 成员(配合 imember_hook)提供 hook：
+ *
+ *   struct job : public ilist_hook<> { ... };
+ *   ilist<job> ready;
+ *
+ *   struct task { ilist_hook<> link; ... };
+ *   ilist<task, imember_hook<task, ilist_hook<>, &task::link> > pending;
+ *
+ * 同一个物件要同时放在几个 ilist 时，以不同的 Tag 区分各个 hook。
+ *
+ * hook 的链接模式(link mode)：
+ *   ilink_normal        不做额外的工作，移出链表后 hook 的内容不确定
+ *   ilink_safe          移出链表后指针归零，可以 is_linked() 检查(缺省)
+ *   ilink_auto_unlink   同 ilink_safe，且物件解构时自动从链表中移除
+ *
+ * ilist 不拥有元素：erase / clear 只解除链接，不解构物件，物件的生命期必须长于链接期间
+ * (auto_unlink 模式除外)。不可复制。
+ * 以 header 形成环状链表，insert / erase / splice 都是 O(1)，size() 需走访整个链表。
+ */
+#ifndef TINYSTL_ILIST_H_
+#define TINYSTL_ILIST_H_
+
+#include "iterator.h"
+
+namespace tinystl
+{
+
+// hook 的链接模式
+enum { ilink_normal, ilink_safe, ilink_auto_unlink };
+
+enum { __IMEMBER_PROBE = 0x1000 }; // 计算成员位移时使用的假位址，对任何型别都已对齐
+
+/**
+ * hook traits：hook 与元素之间的转换
+ * ibase_hook     元素继承 Hook
+ * imember_hook   元素含有型别为 Hook 的成员 Member
+ * 同时适用于 ilist_hook 与 islist_hook
+ */
+template <class T, class Hook>
+  struct ibase_hook
+  {
+    typedef T       value_type;
+    typedef Hook    hook_type;
+
+    static Hook* to_hook(T* p) { return static_cast<Hook*>(p); }
+    static T* to_value(Hook* h) { return static_cast<T*>(h); }
+  };
+template <class T, class Hook, Hook T::* Member>
+  struct imember_hook
+  {
+    typedef T       value_type;
+    typedef Hook    hook_type;
+
+    // 与 offsetof 相同
+    static size_t offset()
+    {
+      return (size_t)&(((T*)__IMEMBER_PROBE)->*Member) - size_t(__IMEMBER_PROBE);
+    }
+    static Hook* to_hook(T* p) { return &(p->*Member); }
+    static T* to_value(Hook* h) { return (T*)((char*)h - offset()); }
+  };
+
+
+// 链接的基本结构，ilist 的 header 也是一个 __ilist_link
+struct __ilist_link
+{
+  __ilist_link* prev;
+  __ilist_link* next;
+};
+
+// 将 [first, last) 移至 position 之前，与 list::transfer 相同
+inline void __ilist_transfer(__ilist_link* position, __ilist_link* first, __ilist_link* last)
+{
+  if (position != last) {
+    last->prev->next = position;
+    first->prev->next = last;
+    position->prev->next = first;
+    __ilist_link* tmp = position->prev;
+    position->prev = last->prev;
+    last->prev = first->prev;
+    first->prev = tmp;
+  }
+}
+
+template <int Mode = ilink_safe, class Tag = void>
+  struct ilist_hook : public __ilist_link
+  {
+    enum { link_mode = Mode };
+
+    ilist_hook() { prev = next = 0; }
+    // 复制物件时不复制链接状态
+    ilist_hook(const ilist_hook&) { prev = next = 0; }
+    ilist_hook& operator=(const ilist_hook&) { return *this; }
+    ~ilist_hook()
+    {
+      if (Mode == ilink_auto_unlink && is_linked()) unlink();
+    }
+
+    // ilink_normal 模式下，移出链表后的结果不确定
+    bool is_linked() const { return next != 0; }
+    // 自行从所在的链表中移除
+    void unlink()
+    {
+      prev->next = next;
+      next->prev = prev;
+      if (Mode != ilink_normal) prev = next = 0;
+    }
+  };
+
+
+// ilist 迭代器
+template <class T, class Ref, class Ptr, class HookTraits>
+  struct __ilist_iterator
+  {
+    typedef __ilist_iterator<T, T&, T*, HookTraits>             iterator;
+    typedef __ilist_iterator<T, const T&, const T*, HookTraits> const_iterator;
+    typedef __ilist_iterator                                    self;
+    typedef typename HookTraits::hook_type                      hook_type;
+
+    typedef bidirectional_iterator_tag    iterator_category;
+    typedef T                             value_type;
+    typedef Ptr                           pointer;
+    typedef Ref                           reference;
+    typedef ptrdiff_t                     difference_type;
+    typedef size_t                        size_type;
+
+    __ilist_link* node;
+
+    __ilist_iterator() : node(0) { }
+    explicit __ilist_iterator(__ilist_link* x) : node(x) { }
+    __ilist_iterator(const iterator& x) : node(x.node) { }
+
+    reference operator*() const { return *HookTraits::to_value(static_cast<hook_type*>(node)); }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      node = node->next;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      node = node->next;
+      return tmp;
+    }
+    self& operator--()
+    {
+      node = node->prev;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      node = node->prev;
+      return tmp;
+    }
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+  };
+
+
+template <class T, class HookTraits = ibase_hook<T, ilist_hook<> > >
+  class ilist
+  {
+    public:
+    typedef T                                   value_type;
+    typedef value_type*                         pointer;
+    typedef value_type&                         reference;
+    typedef const value_type&                   const_reference;
+    typedef size_t                              size_type;
+    typedef ptrdiff_t                           difference_type;
+    typedef HookTraits                          hook_traits;
+    typedef typename HookTraits::hook_type      hook_type;
+    typedef __ilist_iterator<T, T&, T*, HookTraits>             iterator;
+    typedef __ilist_iterator<T, const T&, const T*, HookTraits> const_iterator;
+
+    protected:
+    enum { safe_mode = int(hook_type::link_mode) != int(ilink_normal) };
+
+    __ilist_link header;
+
+    static __ilist_link* link_of(const_reference x)
+    { return HookTraits::to_hook(const_cast<T*>(&x)); }
+    static void reset(__ilist_link* p)
+    {
+      if (safe_mode) p->prev = p->next = 0;
+    }
+
+    private:
+    // 不可复制
+    ilist(const ilist&);
+    ilist& operator=(const ilist&);
+
+    public:
+    ilist() { header.prev = header.next = &header; }
+    // 只解除链接，元素本身不受影响
+    ~ilist() { clear(); }
+
+    iterator begin() { return iterator(header.next); }
+    const_iterator begin() const { return const_iterator(header.next); }
+    iterator end() { return iterator(&header); }
+    const_iterator end() const { return const_iterator(const_cast<__ilist_link*>(&header)); }
+    bool empty() const { return header.next == &header; }
+    size_type size() const
+    {
+      size_type result = 0;
+      for (const __ilist_link* p = header.next; p != &header; p = p->next)
+        ++result;
+      return result;
+    }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *(--end()); }
+    const_reference back() const { return *(--end()); }
+
+    // 由元素本身取得迭代器，x 必须已在某个 ilist 之中
+    static iterator iterator_to(reference x) { return iterator(link_of(x)); }
+    static const_iterator iterator_to(const_reference x) { return const_iterator(link_of(x)); }
+
+    // x 不可已在其他链表之中(safe 模式下可以 is_linked() 检查)
+    iterator insert(iterator position, reference x)
+    {
+      __ilist_link* p = link_of(x);
+      p->next = position.node;
+      p->prev = position.node->prev;
+      position.node->prev->next = p;
+      position.node->prev = p;
+      return iterator(p);
+    }
+    void push_front(reference x) { insert(begin(), x); }
+    void push_back(reference x) { insert(end(), x); }
+    iterator erase(iterator position)
+    {
+      __ilist_link* p = position.node;
+      __ilist_link* next = p->next;
+      p->prev->next = next;
+      next->prev = p->prev;
+      reset(p);
+      return iterator(next);
+    }
+    // normal 模式下为 O(1)，其他模式需逐一归零
+    iterator erase(iterator first, iterator last)
+    {
+      if (first == last) return last;
+      first.node->prev->next = last.node;
+      last.node->prev = first.node->prev;
+      if (safe_mode)
+        while (first != last) {
+          __ilist_link* p = first.node;
+          ++first;
+          reset(p);
+        }
+      return last;
+    }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(header.prev)); }
+    void clear() { erase(begin(), end()); }
+
+    // 将 x 接合于 position 之前，x 必须不同于 *this
+    void splice(iterator position, ilist& x)
+    {
+      if (!x.empty())
+        __ilist_transfer(position.node, x.header.next, &x.header);
+    }
+    // 将 i 所指元素接合于 position 之前，position 和 i 可指向同一个 ilist
+    void splice(iterator position, ilist&, iterator i)
+    {
+      iterator j = i;
+      ++j;
+      if (position == i || position == j) return;
+      __ilist_transfer(position.node, i.node, j.node);
+    }
+    // 将 [first, last) 接合于 position 之前，position 不能位于 [first, last) 之内
+    void splice(iterator position, ilist&, iterator first, iterator last)
+    {
+      if (first != last)
+        __ilist_transfer(position.node, first.node, last.node);
+    }
+
+    void swap(ilist& x)
+    {
+      ilist tmp;
+      tmp.splice(tmp.end(), *this);
+      splice(end(), x);
+      x.splice(x.end(), tmp);
+    }
+    void reverse()
+    {
+      __ilist_link* p = &header;
+      do {
+        __ilist_link* tmp = p->next;
+        p->next = p->prev;
+        p->prev = tmp;
+        p = tmp;
+      } while (p != &header);
+    }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ILIST_H_
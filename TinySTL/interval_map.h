@@ -0,0 +1,185 @@
+
+/**
+ * interval_map
+ * 以半开区间 [lo, hi) 为键值的 multimap，可查询与某个区间重叠、或包含某个点的所有元素。
+ * 以 rb_interval_max 增强的 rb_tree：元素依 (lo, hi) 排序，每个节点记录子树中最大的 hi，
+ * 搜寻时整个子树的最大 hi 不超过查询的起点便可略过。
+ *   find_overlap(lo, hi)        任一与 [lo, hi) 重叠的元素，没有时为 end()，O(log n)
+ *   overlaps(lo, hi, result)    依序将所有与 [lo, hi) 重叠的元素的迭代器写至 result
+ *   stab(p, result)             依序将所有包含 p 的元素的迭代器写至 result
+ * 后两者为 O(min(n, (k + 1) log n))，k 为符合的元素个数。
+ *
+ * 插入的区间必须非空(lo < hi)；查询空区间时没有结果。
+ * Compare 必须可以预设构造(计算节点附加资料时另外产生)。
+ * 键值不可经由迭代器修改，mapped 值可以。
+ */
+#ifndef TINYSTL_INTERVAL_MAP_H_
+#define TINYSTL_INTERVAL_MAP_H_
+
+#include "alloc.h"
+#include "pair.h"
+#include "function.h"
+#include "tree.h"
+
+namespace tinystl
+{
+
+// 依 (lo, hi) 的字典顺序比较区间
+template <class Key, class Compare>
+  struct __interval_less : public binary_function<pair<Key, Key>, pair<Key, Key>, bool>
+  {
+    Compare comp;
+    __interval_less(const Compare& c = Compare()) : comp(c) { }
+    bool operator()(const pair<Key, Key>& x, const pair<Key, Key>& y) const
+    {
+      return comp(x.first, y.first) || (!comp(y.first, x.first) && comp(x.second, y.second));
+    }
+  };
+
+// rb_tree 的增强：子树中最大的区间终点
+template <class Key, class Compare>
+  struct rb_interval_max
+  {
+    typedef Key meta_type;
+
+    template <class Value>
+      static void update(meta_type& m, const Value& v, const meta_type* left, const meta_type* right)
+      {
+        Compare comp;
+        m = v.first.second;
+        if (left && comp(m, *left)) m = *left;
+        if (right && comp(m, *right)) m = *right;
+      }
+  };
+
+template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+  class interval_map
+  {
+    public:
+    typedef pair<Key, Key>                     key_type;   // [first, second)
+    typedef Key                                bound_type;
+    typedef T                                  data_type;
+    typedef T                                  mapped_type;
+    typedef pair<const key_type, T>            value_type;
+    typedef __interval_less<Key, Compare>      key_compare;
+
+    private:
+    typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc,
+                    rb_interval_max<Key, Compare> > rep_type;
+    typedef typename rep_type::link_type          link_type;
+    rep_type t;
+    Compare bound_compare;
+
+    public:
+    typedef typename rep_type::iterator           iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::reference          reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    private:
+    static const key_type& key(link_type x) { return x->value_field.first; }
+    // 以 x 为根的子树中可能有与 [lo, ...) 重叠的区间
+    bool may_reach(link_type x, const Key& lo) const { return x != 0 && bound_compare(lo, x->meta); }
+    // closed 为 true 时查询 [lo, hi]，用于 stab
+    template <class OutputIterator>
+      OutputIterator collect(link_type x, const Key& lo, const Key& hi, bool closed,
+                             OutputIterator result) const;
+
+    public:
+    // 构造
+    interval_map() : t(key_compare()) { }
+    template <class InputIterator>
+      interval_map(InputIterator first, InputIterator last) : t(key_compare())
+      { t.insert_equal(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    iterator begin() { return t.begin(); }
+    const_iterator begin() const { return t.begin(); }
+    iterator end() { return t.end(); }
+    const_iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    void swap(interval_map& x) { t.swap(x.t); }
+
+    // 插入、删除；相同的区间可以出现多次
+    iterator insert(const value_type& x) { return t.insert_equal(x); }
+    iterator insert(const Key& lo, const Key& hi, const T& x) { return t.insert_equal(value_type(key_type(lo, hi), x)); }
+    iterator insert(iterator position, const value_type& x) { return t.insert_equal(position, x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_equal(first, last); }
+    // 以依 (lo, hi) 排序的 [first, last) 取代原有内容，O(n)
+    template <class ForwardIterator>
+      void assign_sorted(ForwardIterator first, ForwardIterator last) { t.assign_sorted(first, last); }
+    void erase(iterator position) { t.erase(position); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(iterator first, iterator last) { t.erase(first, last); }
+    void clear() { t.clear(); }
+
+    // 依完整的区间搜寻
+    iterator find(const key_type& x) { return t.find(x); }
+    const_iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) { return t.lower_bound(x); }
+    const_iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) { return t.upper_bound(x); }
+    const_iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+
+    // 重叠查询
+    iterator find_overlap(const Key& lo, const Key& hi);
+    template <class OutputIterator>
+      OutputIterator overlaps(const Key& lo, const Key& hi, OutputIterator result)
+      {
+        if (!bound_compare(lo, hi)) return result;
+        return collect(t.__root(), lo, hi, false, result);
+      }
+    template <class OutputIterator>
+      OutputIterator stab(const Key& p, OutputIterator result)
+      {
+        return collect(t.__root(), p, p, true, result);
+      }
+  };
+
+template <class Key, class T, class Compare, class Alloc>
+  typename interval_map<Key, T, Compare, Alloc>::iterator
+  interval_map<Key, T, Compare, Alloc>::find_overlap(const Key& lo, const Key& hi)
+  {
+    if (!bound_compare(lo, hi)) return end();
+    link_type x = t.__root();
+    while (x != 0) {
+      if (bound_compare(key(x).first, hi) && bound_compare(lo, key(x).second))
+        return iterator(x);
+      // 左子树有终点超过 lo 的区间：若它不重叠，起点必定不小于 hi，右子树的起点更大，也不会重叠
+      if (may_reach((link_type)x->left, lo))
+        x = (link_type)x->left;
+      else
+        x = (link_type)x->right;
+    }
+    return end();
+  }
+
+template <class Key, class T, class Compare, class Alloc>
+  template <class OutputIterator>
+  OutputIterator interval_map<Key, T, Compare, Alloc>::collect(link_type x, const Key& lo, const Key& hi,
+                                                               bool closed, OutputIterator result) const
+  {
+    // 沿左子节点递回、沿右子节点迭代，递回深度不超过树高
+    while (may_reach(x, lo)) {
+      result = collect((link_type)x->left, lo, hi, closed, result);
+      const Key& start = key(x).first;
+      // x 的起点已超出查询范围，右子树的起点更大
+      if (closed ? bound_compare(hi, start) : !bound_compare(start, hi))
+        break;
+      if (bound_compare(lo, key(x).second))
+        *result++ = iterator(x);
+      x = (link_type)x->right;
+    }
+    return result;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_INTERVAL_MAP_H_
@@ -0,0 +1,241 @@
+
+/**
+ * islist
+ * 侵入式(intrusive)单向链表，hook 只有一个 next 指针(__slist_node_base)，
+ * 元素以继承 islist_hook 或含有 islist_hook 成员提供 hook，用法与 ilist 相同：
+ *
+ *   struct msg : public islist_hook<> { ... };
+ *   islist<msg> free_msgs;
+ *
+ * 链接模式同 ilist(ilink_normal / ilink_safe / ilink_auto_unlink)。
+ * 单向链表找不到前一个节点，auto_unlink 的 hook 解构时需绕行整个环状链表，为 O(n)。
+ *
+ * 迭代器为 Forward Iterator。与 slist 一样只能在某个位置之后插入、删除；
+ * 以 header 形成环状链表，before_begin() 即 header。不拥有元素，不可复制。
+ */
+#ifndef TINYSTL_ISLIST_H_
+#define TINYSTL_ISLIST_H_
+
+#include "ilist.h"
+#include "slist.h"
+#include "iterator.h"
+
+namespace tinystl
+{
+
+template <int Mode = ilink_safe, class Tag = void>
+  struct islist_hook : public __slist_node_base
+  {
+    enum { link_mode = Mode };
+
+    islist_hook() { next = 0; }
+    // 复制物件时不复制链接状态
+    islist_hook(const islist_hook&) { next = 0; }
+    islist_hook& operator=(const islist_hook&) { return *this; }
+    ~islist_hook()
+    {
+      if (Mode == ilink_auto_unlink && is_linked()) unlink();
+    }
+
+    // ilink_normal 模式下，移出链表后的结果不确定
+    bool is_linked() const { return next != 0; }
+    // 自行从所在的链表中移除，需绕行整个链表找出前一个节点
+    void unlink()
+    {
+      __slist_node_base* prev = next;
+      while (prev->next != this) prev = prev->next;
+      prev->next = next;
+      if (Mode != ilink_normal) next = 0;
+    }
+  };
+
+
+// islist 迭代器
+template <class T, class Ref, class Ptr, class HookTraits>
+  struct __islist_iterator
+  {
+    typedef __islist_iterator<T, T&, T*, HookTraits>             iterator;
+    typedef __islist_iterator<T, const T&, const T*, HookTraits> const_iterator;
+    typedef __islist_iterator                                    self;
+    typedef typename HookTraits::hook_type                       hook_type;
+
+    typedef forward_iterator_tag          iterator_category;
+    typedef T                             value_type;
+    typedef Ptr                           pointer;
+    typedef Ref                           reference;
+    typedef ptrdiff_t                     difference_type;
+    typedef size_t                        size_type;
+
+    __slist_node_base* node;
+
+    __islist_iterator() : node(0) { }
+    explicit __islist_iterator(__slist_node_base* x) : node(x) { }
+    __islist_iterator(const iterator& x) : node(x.node) { }
+
+    reference operator*() const { return *HookTraits::to_value(static_cast<hook_type*>(node)); }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      node = node->next;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      node = node->next;
+      return tmp;
+    }
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return node != x.node; }
+  };
+
+
+template <class T, class HookTraits = ibase_hook<T, islist_hook<> > >
+  class islist
+  {
+    public:
+    typedef T                                   value_type;
+    typedef value_type*                         pointer;
+    typedef value_type&                         reference;
+    typedef const value_type&                   const_reference;
+    typedef size_t                              size_type;
+    typedef ptrdiff_t                           difference_type;
+    typedef HookTraits                          hook_traits;
+    typedef typename HookTraits::hook_type      hook_type;
+    typedef __islist_iterator<T, T&, T*, HookTraits>             iterator;
+    typedef __islist_iterator<T, const T&, const T*, HookTraits> const_iterator;
+
+    protected:
+    enum { safe_mode = int(hook_type::link_mode) != int(ilink_normal) };
+
+    __slist_node_base header;
+
+    static __slist_node_base* link_of(const_reference x)
+    { return HookTraits::to_hook(const_cast<T*>(&x)); }
+    static void reset(__slist_node_base* p)
+    {
+      if (safe_mode) p->next = 0;
+    }
+    // 将 (before_first, before_last] 移至 position 之后
+    static void transfer_after(__slist_node_base* position,
+                               __slist_node_base* before_first, __slist_node_base* before_last)
+    {
+      if (position != before_first && position != before_last) {
+        __slist_node_base* first = before_first->next;
+        __slist_node_base* after = position->next;
+        before_first->next = before_last->next;
+        position->next = first;
+        before_last->next = after;
+      }
+    }
+
+    private:
+    // 不可复制
+    islist(const islist&);
+    islist& operator=(const islist&);
+
+    public:
+    islist() { header.next = &header; }
+    // 只解除链接，元素本身不受影响
+    ~islist() { clear(); }
+
+    iterator before_begin() { return iterator(&header); }
+    const_iterator before_begin() const
+    { return const_iterator(const_cast<__slist_node_base*>(&header)); }
+    iterator begin() { return iterator(header.next); }
+    const_iterator begin() const { return const_iterator(header.next); }
+    iterator end() { return iterator(&header); }
+    const_iterator end() const { return before_begin(); }
+    bool empty() const { return header.next == &header; }
+    size_type size() const
+    {
+      size_type result = 0;
+      for (const __slist_node_base* p = header.next; p != &header; p = p->next)
+        ++result;
+      return result;
+    }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+
+    // 由元素本身取得迭代器，x 必须已在某个 islist 之中
+    static iterator iterator_to(reference x) { return iterator(link_of(x)); }
+    static const_iterator iterator_to(const_reference x) { return const_iterator(link_of(x)); }
+    // position 的前一个位置，需由头走访，为 O(n)
+    iterator previous(iterator position)
+    {
+      __slist_node_base* p = &header;
+      while (p->next != position.node) p = p->next;
+      return iterator(p);
+    }
+
+    // x 不可已在其他链表之中(safe 模式下可以 is_linked() 检查)
+    iterator insert_after(iterator position, reference x)
+    { return iterator(__slist_make_link(position.node, link_of(x))); }
+    void push_front(reference x) { insert_after(before_begin(), x); }
+    // 移除 position 之后的元素，传回其后的位置
+    iterator erase_after(iterator position)
+    {
+      __slist_node_base* p = position.node->next;
+      position.node->next = p->next;
+      reset(p);
+      return iterator(position.node->next);
+    }
+    // 移除 (before_first, last)，normal 模式下为 O(1)，其他模式需逐一归零
+    iterator erase_after(iterator before_first, iterator last)
+    {
+      __slist_node_base* p = before_first.node->next;
+      before_first.node->next = last.node;
+      if (safe_mode)
+        while (p != last.node) {
+          __slist_node_base* next = p->next;
+          reset(p);
+          p = next;
+        }
+      return last;
+    }
+    void pop_front() { erase_after(before_begin()); }
+    void clear() { erase_after(before_begin(), end()); }
+
+    // 将 (before_first, before_last] 接合于 position 之后，O(1)
+    // position 不能位于 (before_first, before_last] 之内
+    void splice_after(iterator position, islist&, iterator before_first, iterator before_last)
+    {
+      transfer_after(position.node, before_first.node, before_last.node);
+    }
+    // 将 before_first 之后的一个元素接合于 position 之后
+    void splice_after(iterator position, islist& x, iterator before_first)
+    {
+      iterator i = before_first;
+      splice_after(position, x, before_first, ++i);
+    }
+    // 将 x 的全部元素接合于 position 之后，x 必须不同于 *this；需找出 x 的最后一个节点，为 O(n)
+    void splice_after(iterator position, islist& x)
+    {
+      if (!x.empty())
+        transfer_after(position.node, &x.header, x.previous(x.end()).node);
+    }
+
+    void swap(islist& x)
+    {
+      islist tmp;
+      tmp.splice_after(tmp.before_begin(), *this);
+      splice_after(before_begin(), x);
+      x.splice_after(x.before_begin(), tmp);
+    }
+    void reverse()
+    {
+      __slist_node_base* prev = &header;
+      __slist_node_base* p = header.next;
+      while (p != &header) {
+        __slist_node_base* next = p->next;
+        p->next = prev;
+        prev = p;
+        p = next;
+      }
+      header.next = prev;
+    }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ISLIST_H_
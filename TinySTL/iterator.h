@@ -67,8 +67,8 @@ template <class T>
   {
     typedef random_access_iterator_tag     iterator_category;
     typedef T                              value_type;
-    typedef T*                             pointer;
-    typedef T&                             reference;
+    typedef const T*                       pointer;
+    typedef const T&                       reference;
     typedef ptrdiff_t                      difference_type;
   };
 
@@ -78,7 +78,7 @@ template <class Iterator>
   inline typename iterator_traits<Iterator>::iterator_category
   iterator_category(const Iterator&)
   {
-    typedef typename iterator_traits<Iterator>::iterator_categoey category;
+    typedef typename iterator_traits<Iterator>::iterator_category category;
     return category();
   }
 // 决定迭代器的 value_type
@@ -93,7 +93,7 @@ template <class Iterator>
   inline typename iterator_traits<Iterator>::difference_type*
   distance_type(const Iterator&)
   {
-    return static_cast<typename iterator_traits<ITerator>::difference_type*>(0);
+    return static_cast<typename iterator_traits<Iterator>::difference_type*>(0);
   }
 
 
@@ -105,7 +105,7 @@ template <class InputIterator>
   __distance(InputIterator first, InputIterator last,
              input_iterator_tag)
   {
-    iterator_traits<InputIterator>::difference_type n = 0;
+    typename iterator_traits<InputIterator>::difference_type n = 0;
     while (first != last) {
       ++first; ++n;
     }
@@ -133,14 +133,14 @@ template <class InputIterator, class Distance>
   inline void __advance(InputIterator& i, Distance n,
                         input_iterator_tag)
   {
-    while (--n) ++i;
+    while (n--) ++i;
   }
 template <class BidirectionalIterator, class Distance>
   inline void __advance(BidirectionalIterator& i, Distance n,
                         bidirectional_iterator_tag)
   {
-    if (n >= 0) while (--n) ++i;
-    else while (++n) --i;
+    if (n >= 0) while (n--) ++i;
+    else while (n++) --i;
   }
 template <class RandomAccessIterator, class Distance>
   inline void __advance(RandomAccessIterator& i, Distance n,
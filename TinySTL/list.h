@@ -1,11 +1,13 @@
 #ifndef TINYSTL_LIST_H_
 #define TINYSTL_LIST_H_
 
+#include <stdlib.h> // for malloc() free()
 #include "alloc.h"
 #include "iterator.h"
 #include "algobase.h"
 #include "construct.h"
 #include "type_traits.h"
+#include "node_arena.h"
 
 namespace tinystl
 {
@@ -14,7 +16,7 @@ namespace tinystl
 template <class T>
   struct __list_node
   {
-    typedef void* void__pointer;
+    typedef void* void_pointer;
     void_pointer prev; // 可设计为 __list_node<T>*
     void_pointer next;
     T data;
@@ -60,7 +62,7 @@ template <class T, class Ref, class Ptr>
     }
     self& operator--()
     {
-      node = link_ttype((*node).prev);
+      node = link_type((*node).prev);
       return *this;
     }
     self operator--(int)
@@ -72,41 +74,48 @@ template <class T, class Ref, class Ptr>
   };
 
 // list
+// Alloc 为 node_arena<> 时，节点来自 list 自己的节点区，见 node_arena.h
 template <class T, class Alloc = alloc>
-  class list
+  class list : protected __node_storage<__list_node<T>, Alloc>
   {
     protected:
-    typedef size_t                             size_type;
     typedef __list_node<T>                     list_node;
-    typedef __list_iterator<T, T&, T*>         iterator;
-    typedef simple_alloc<list_node, Alloc>     list_node_allocator;
+    typedef __node_storage<list_node, Alloc>   node_storage;
     public:
+    typedef T                                  value_type;
+    typedef value_type*                        pointer;
+    typedef value_type&                        reference;
+    typedef const value_type&                  const_reference;
+    typedef size_t                             size_type;
+    typedef ptrdiff_t                          difference_type;
+    typedef __list_iterator<T, T&, T*>         iterator;
     typedef list_node*                         link_type;
     protected:
     link_type node;
+    size_type length; // 元素个数，所有插入、删除与 splice 都会维护
 
     // 利用迭代器完成的简单工作
     public:
     iterator begin() { return link_type((*node).next); }
     iterator end() { return node; }
     bool empty() const { return node->next == node; }
-    size_type size() const
-    {
-      size_type result = 0;
-      distance(begin(), end(), result);
-      return result;
-    }
+    size_type size() const { return length; }
     reference front() { return *begin(); }
     reference back() { return *(--end()); }
 
     // 构造与内存管理
     protected:
-    link_type get_node() { return list_node_allocator::allocate(); }
-    void put_node(link_type p) { list_node_allocator::deallocate(p); }
+    link_type get_node() { return this->allocate_node(); }
+    void put_node(link_type p) { this->deallocate_node(p); }
     link_type create_node(const T& x)
     {
       link_type p = get_node();
-      construct(&p->data, x);
+      try {
+        construct(&p->data, x);
+      } catch(...) {
+        put_node(p);
+        throw;
+      }
       return p;
     }
     void destroy_node(link_type p)
@@ -118,12 +127,50 @@ template <class T, class Alloc = alloc>
     // 构造函数
     public:
     list() { empty_initialize(); }
+    // 逐一复制元素；使用 node_arena 时新的 list 有自己的节点区
+    list(const list& x) : node_storage()
+    {
+      empty_initialize();
+      try {
+        for (link_type cur = link_type(x.node->next); cur != x.node; cur = link_type(cur->next))
+          push_back(cur->data);
+      } catch(...) {
+        clear();
+        this->deallocate_header(node);
+        throw;
+      }
+    }
+    ~list()
+    {
+      clear();
+      this->deallocate_header(node);
+    }
+    // 复制至暂时的 list 再交换，复制失败时原有内容不变
+    list& operator=(const list& x)
+    {
+      if (this != &x) {
+        list tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(list& x)
+    {
+      link_type tmp = node;
+      node = x.node;
+      x.node = tmp;
+      size_type n = length;
+      length = x.length;
+      x.length = n;
+      this->swap_nodes(x);
+    }
     protected:
-    void empty_initialized()
+    void empty_initialize()
     {
-      node = get_node();
-      node_next = node;
-      node_prev = node;
+      node = this->allocate_header();
+      node->next = node;
+      node->prev = node;
+      length = 0;
     }
 
     // 元素操作
@@ -135,6 +182,7 @@ template <class T, class Alloc = alloc>
       tmp->prev = position.node->prev;
       (link_type(position.node->prev))->next = tmp;
       position.node->prev = tmp;
+      ++length;
       return tmp;
     }
     void push_front(const T& x) { insert(begin(), x); }
@@ -146,6 +194,7 @@ template <class T, class Alloc = alloc>
       prev_node->next = next_node;
       next_node->prev = prev_node;
       destroy_node(position.node);
+      --length;
       return iterator(next_node);
     }
     void pop_front() { erase(begin()); }
@@ -155,6 +204,7 @@ template <class T, class Alloc = alloc>
       erase(--tmp);
     }
     // 清除所有节点
+    // 使用 node_arena 时一次将节点全部归还节点区，元素有 trivial destructor 时为 O(chunks)
     void clear();
     // 将数值为 value 的所有元素移除
     void remove(const T& value);
@@ -169,34 +219,63 @@ template <class T, class Alloc = alloc>
         (*link_type((*last.node).prev)).next = position.node;
         (*link_type((*first.node).prev)).next = last.node;
         (*link_type((*position.node).prev)).next = first.node;
-        link_type tmp = link_type((position.node).prev);
+        link_type tmp = link_type((*position.node).prev);
         (*position.node).prev = (*last.node).prev;
         (*last.node).prev = (*first.node).prev;
         (*first.node).prev = tmp;
       }
     }
+    // 将 x 的 [first, last) 移至 position 之前，n 为区间的元素个数(x 就是 *this 时不使用)
+    // x 的节点属于另一个节点区时无法串接，改为复制元素再自 x 删除
+    void transfer(iterator position, list& x, iterator first, iterator last, size_type n)
+    {
+      if (this->shares_nodes(x)) {
+        transfer(position, first, last);
+        length += n;
+        x.length -= n;
+        return;
+      }
+      while (first != last) {
+        insert(position, *first);
+        first = x.erase(first);
+      }
+    }
+    // 解构 [first, last) 的元素，不释还节点
+    void destroy_values(iterator first, iterator last, __false_type)
+    {
+      for ( ; first != last; ++first)
+        destroy(&*first);
+    }
+    void destroy_values(iterator, iterator, __true_type) { }
     public:
     // 将 x 接合于 position 之前，x 必须不同于 *this
     void splice(iterator position, list& x)
     {
       if (!x.empty())
-        transfer(position, x.begin(), x.end());
+        transfer(position, x, x.begin(), x.end(), x.length);
     }
     // 将 i 所指元素接合于 position 之前，position 和 i 可指向同一个 list
-    void splice(iterator position, list&, iterator i)
+    void splice(iterator position, list& x, iterator i)
     {
       iterator j = i;
       ++j;
       if (position == i || position == j) return;
-      transfer(position, i, j);
+      transfer(position, x, i, j, 1);
     }
     // 将 [first, last) 内所有元素接合于 position 之前
     // position 和 [first, last) 可指向同一个 list
     // position 不能位于 [first, last) 之内
-    void splice(lierator position, list&, iterator first, iterator last)
+    // x 不同于 *this 时需走访区间以计算元素个数，为 O(n)；已知个数时改用下一个版本
+    void splice(iterator position, list& x, iterator first, iterator last)
     {
       if (first != last)
-        transfer(position, first, last);
+        transfer(position, x, first, last, &x == this ? 0 : size_type(tinystl::distance(first, last)));
+    }
+    // 同上，n 必须等于 [first, last) 的元素个数，为 O(1)
+    void splice(iterator position, list& x, iterator first, iterator last, size_type n)
+    {
+      if (first != last)
+        transfer(position, x, first, last, n);
     }
 
     // 将 x 合并到 *this，两个 list 必须先经过递增排序
@@ -204,21 +283,36 @@ template <class T, class Alloc = alloc>
     // 将 *this 的内容逆向重置
     void reverse();
     // 不能使用STL算法 sort()，因为其接受 RandomAccessIterator
-    // quick sort
+    // 先将节点指针收集至连续的缓冲区，以 merge sort 排序后一次重新串接；
+    // 比较过程中不改动任何节点，比较抛出异常时 list 保持原样。稳定排序
     void sort();
+    protected:
+    // 不另外配置空间的 merge sort，以 64 个 list 作为计数器。
+    // 缓冲区配置失败时改用
+    void merge_sort();
   };
 
 template <class T, class Alloc>
   void list<T, Alloc>::clear()
   {
-    link_type cur = link_type(node_next);
+    if (node_storage::arena) {
+      typedef typename __type_traits<T>::has_trivial_destructor trivial_destructor;
+      destroy_values(begin(), end(), trivial_destructor());
+      this->release_nodes();
+      node->next = node;
+      node->prev = node;
+      length = 0;
+      return;
+    }
+    link_type cur = link_type(node->next);
     while (cur != node) {
-      link_type tmp = cut;
+      link_type tmp = cur;
       cur = link_type(cur->next);
       destroy_node(tmp);
     }
     node->next = node;
     node->prev = node;
+    length = 0;
   }
 template <class T, class Alloc>
   void list<T, Alloc>::remove(const T& value)
@@ -256,10 +350,12 @@ template <class T, class Alloc>
     while (first1 != last1 && first2 != last2)
       if (*first2 < *first1) {
         iterator next = first2;
-        transfer(first1, first2, ++next);
+        transfer(first1, x, first2, ++next, 1);
+        first2 = next;
       } else
         ++first1;
-      if (first2 != last2) transfer(last1, first2, last2);
+    // x 剩下的就是 [first2, last2)
+    if (first2 != last2) transfer(last1, x, first2, last2, x.length);
   }
 template <class T, class Alloc>
   void list<T, Alloc>::reverse()
@@ -274,8 +370,90 @@ template <class T, class Alloc>
       transfer(begin(), old, first);
     }
   }
+
+
+/**
+ * list::sort() 使用的辅助函数，对节点指针数组排序，比较所指节点的 data
+ * 相等的元素维持原本的先后次序
+ */
+enum { __LIST_SORT_RUN = 16 }; // 先以 insertion sort 排好的小段长度
+
+template <class Link>
+  void __list_insertion_sort_links(Link* first, Link* last)
+  {
+    if (first == last) return;
+    for (Link* i = first + 1; i != last; ++i) {
+      Link value = *i;
+      Link* j = i;
+      for ( ; j != first && value->data < (*(j - 1))->data; --j)
+        *j = *(j - 1);
+      *j = value;
+    }
+  }
+// 合并 [first1, last1) 与 [first2, last2) 至 result，相等时先取前段
+template <class Link>
+  Link* __list_merge_links(Link* first1, Link* last1, Link* first2, Link* last2, Link* result)
+  {
+    while (first1 != last1 && first2 != last2)
+      if ((*first2)->data < (*first1)->data) *result++ = *first2++;
+      else *result++ = *first1++;
+    result = tinystl::copy(first1, last1, result);
+    return tinystl::copy(first2, last2, result);
+  }
+// 由下而上的 merge sort，a 与 b 各可放 n 个指针，传回结果所在的那一块
+template <class Link>
+  Link* __list_sort_links(Link* a, Link* b, size_t n)
+  {
+    for (size_t i = 0; i < n; i += __LIST_SORT_RUN)
+      tinystl::__list_insertion_sort_links(a + i, a + tinystl::min(i + __LIST_SORT_RUN, n));
+    for (size_t width = __LIST_SORT_RUN; width < n; width *= 2) {
+      for (size_t i = 0; i < n; i += 2 * width) {
+        const size_t mid = tinystl::min(i + width, n);
+        const size_t last = tinystl::min(i + 2 * width, n);
+        tinystl::__list_merge_links(a + i, a + mid, a + mid, a + last, b + i);
+      }
+      Link* tmp = a;
+      a = b;
+      b = tmp;
+    }
+    return a;
+  }
+
 template <class T, class Alloc>
   void list<T, Alloc>::sort()
+  {
+    if (node->next == node || link_type(node->next)->next == node)
+      return;
+    size_type n = length;
+    // 不经过 alloc：大块空间本来就交给 malloc()，且配置失败时不应结束程序
+    link_type* buf = (link_type*)malloc(2 * n * sizeof(link_type));
+    if (buf == 0) {
+      merge_sort();
+      return;
+    }
+    link_type* cur = buf;
+    for (link_type p = link_type(node->next); p != node; p = link_type(p->next))
+      *cur++ = p;
+    link_type* sorted;
+    try {
+      sorted = tinystl::__list_sort_links(buf, buf + n, n);
+    } catch(...) {
+      free(buf);
+      throw;
+    }
+    // 依排序结果重新串接
+    link_type prev = node;
+    for (size_type i = 0; i < n; ++i) {
+      prev->next = sorted[i];
+      sorted[i]->prev = prev;
+      prev = sorted[i];
+    }
+    prev->next = node;
+    node->prev = prev;
+    free(buf);
+  }
+template <class T, class Alloc>
+  void list<T, Alloc>::merge_sort()
   {
     if (node->next == node || link_type(node->next)->next == node)
       return;
@@ -290,7 +468,7 @@ template <class T, class Alloc>
         carry.swap(counter[i++]);
       }
       carry.swap(counter[i]);
-      if (i == fill) ++file;
+      if (i == fill) ++fill;
     }
     for (int i = 1; i < fill; ++i)
       counter[i].merge(counter[i-1]);
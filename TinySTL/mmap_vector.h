@@ -0,0 +1,260 @@
+
+/**
+ * mmap_vector
+ * 以档案为后备存储(file-backed)的 vector，元素直接位于 mmap() 映射的页面上
+ * 仅适用于 trivially copyable 的 T，档案内容就是元素的原始位元组。
+ *
+ * mmap_vector<T>：可读写，档案不存在时建立。
+ *                 push_back() / resize() 超出容量时延长档案并重新映射，
+ *                 此后所有指向元素的指针、迭代器失效。
+ *                 延长或映射失败时与 open() 相同以 false 回报，原有的映射与元素不变；
+ *                 尚未开启时一律传回 false。
+ * mmap_vector<const T>：唯读，开启时只建立映射，不读取任何内容，花费 O(1)。
+ *                       以 PROT_READ、MAP_SHARED 映射，多个行程(process)共用同一份 page cache。
+ *                       只提供 const 的存取，呼叫修改容器的函数无法通过编译。
+ *
+ * 档案大小在使用中会被延长至容量，close() 时截回 size() * sizeof(T)。
+ * 若行程异常结束，档案尾端可能留有为 0 的多余元素。
+ *
+ * 依赖 POSIX 的 open() / mmap() / msync() / ftruncate()。
+ */
+#ifndef TINYSTL_MMAP_VECTOR_H_
+#define TINYSTL_MMAP_VECTOR_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vector.h" // for vector_growth_2x
+#include "algobase.h"
+
+namespace tinystl
+{
+
+// 以元素型别是否为 const 区分可读写与唯读的映射
+template <class T>
+  struct __mmap_element
+  {
+    typedef T value_type;
+    enum { writable = true };
+  };
+template <class T>
+  struct __mmap_element<const T>
+  {
+    typedef T value_type;
+    enum { writable = false };
+  };
+
+template <class T>
+  class mmap_vector
+  {
+#if defined(__GNUC__)
+    static_assert(__is_trivially_copyable(T), "mmap_vector requires a trivially copyable T");
+#endif
+    public:
+    // 型别定义
+    typedef typename __mmap_element<T>::value_type value_type;
+    typedef T*                    pointer;
+    typedef const value_type*     const_pointer;
+    typedef T*                    iterator; // Random Access Iterator
+    typedef const value_type*     const_iterator;
+    typedef T&                    reference;
+    typedef const value_type&     const_reference;
+    typedef size_t                size_type;
+    typedef ptrdiff_t             difference_type;
+
+    enum { writable = __mmap_element<T>::writable };
+
+    protected:
+    int fd;
+    iterator start;   // 映射区域的头
+    size_type mapped; // 映射区域的 bytes 数
+    size_type num;    // 元素个数
+    size_type cap;    // 映射区域可容纳的元素个数
+
+    static size_type page_size() { return size_type(sysconf(_SC_PAGESIZE)); }
+    // 将 n 个元素所需的 bytes 上调至页面大小的倍数
+    static size_type round_to_page(size_type n)
+    {
+      size_type bytes = n * sizeof(value_type);
+      size_type page = page_size();
+      return (bytes + page - 1) / page * page;
+    }
+    // 映射档案的前 bytes 个 bytes，失败时传回 0，不改变目前的映射
+    iterator map_region(size_type bytes)
+    {
+      int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+      void* p = mmap(0, bytes, prot, MAP_SHARED, fd, 0);
+      return p == MAP_FAILED ? 0 : (iterator)p;
+    }
+    bool map(size_type bytes)
+    {
+      mapped = 0;
+      start = 0;
+      if (bytes == 0) return true;
+      if (!(start = map_region(bytes))) return false;
+      mapped = bytes;
+      return true;
+    }
+    void unmap()
+    {
+      if (start) munmap((void*)start, mapped);
+      start = 0;
+      mapped = 0;
+    }
+    // 延长档案至可容纳 n 个元素，并重新映射；失败时保留原有的映射
+    bool remap(size_type n);
+    bool grow_for(size_type n)
+    {
+      if (num + n <= cap) return true;
+      return remap(vector_growth_2x::new_capacity(num, n, sizeof(value_type)));
+    }
+
+    public:
+    mmap_vector() : fd(-1), start(0), mapped(0), num(0), cap(0) { }
+    explicit mmap_vector(const char* path)
+    : fd(-1), start(0), mapped(0), num(0), cap(0)
+    { open(path); }
+    ~mmap_vector() { close(); }
+
+    // 开启并映射档案，可读写时档案不存在则建立
+    bool open(const char* path);
+    // 写回、截去多余容量并解除映射
+    // 写回或截断失败时传回 false，映射与档案仍然关闭
+    bool close();
+    bool is_open() const { return fd >= 0; }
+
+    // 将修改写回档案
+    // async 为 true 时只排定写回(MS_ASYNC)，否则等待完成(MS_SYNC)
+    bool flush(bool async = false)
+    {
+      if (!start || !writable) return true;
+      return msync((void*)start, mapped, async ? MS_ASYNC : MS_SYNC) == 0;
+    }
+    // 告知核心接下来的存取模式，例如 MADV_SEQUENTIAL / MADV_RANDOM / MADV_WILLNEED
+    bool advise(int advice)
+    {
+      if (!start) return true;
+      return madvise((void*)start, mapped, advice) == 0;
+    }
+
+    // 利用迭代器能简单完成的工作
+    iterator begin() { return start; }
+    const_iterator begin() const { return start; }
+    iterator end() { return start + num; }
+    const_iterator end() const { return start + num; }
+    pointer data() { return start; }
+    const_pointer data() const { return start; }
+    size_type size() const { return num; }
+    size_type capacity() const { return cap; }
+    bool empty() const { return num == 0; }
+    reference operator[](size_type n) { return start[n]; }
+    const_reference operator[](size_type n) const { return start[n]; }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *(end() - 1); }
+    const_reference back() const { return *(end() - 1); }
+
+    // 以下仅适用于可读写的映射，需要扩充而失败时传回 false
+    bool reserve(size_type n)
+    {
+      static_assert(writable, "mmap_vector<const T> is read-only");
+      return cap >= n || remap(n);
+    }
+    // x 可以是容器内的元素，先行复制，重新映射后仍然有效
+    bool push_back(const value_type& x)
+    {
+      static_assert(writable, "mmap_vector<const T> is read-only");
+      const value_type x_copy = x;
+      if (!grow_for(1)) return false;
+      start[num++] = x_copy;
+      return true;
+    }
+    void pop_back()
+    {
+      static_assert(writable, "mmap_vector<const T> is read-only");
+      --num;
+    }
+    bool resize(size_type new_size, const value_type& x = value_type())
+    {
+      static_assert(writable, "mmap_vector<const T> is read-only");
+      if (new_size > num) {
+        const value_type x_copy = x;
+        if (!grow_for(new_size - num)) return false;
+        tinystl::fill(start + num, start + new_size, x_copy);
+      }
+      num = new_size;
+      return true;
+    }
+    void clear()
+    {
+      static_assert(writable, "mmap_vector<const T> is read-only");
+      num = 0;
+    }
+
+    private:
+    // 映射不可复制
+    mmap_vector(const mmap_vector&);
+    mmap_vector& operator=(const mmap_vector&);
+  };
+
+template <class T>
+  bool mmap_vector<T>::open(const char* path)
+  {
+    close();
+    fd = ::open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      ::close(fd);
+      fd = -1;
+      return false;
+    }
+    num = cap = size_type(st.st_size) / sizeof(value_type);
+    if (!map(size_type(st.st_size))) {
+      ::close(fd);
+      fd = -1;
+      num = cap = 0;
+      return false;
+    }
+    return true;
+  }
+
+template <class T>
+  bool mmap_vector<T>::close()
+  {
+    if (fd < 0) return true;
+    bool ok = flush();
+    unmap();
+    // 截断失败时档案保留多余的容量，内容仍然正确
+    if (writable && ftruncate(fd, off_t(num * sizeof(value_type))) != 0)
+      ok = false;
+    ::close(fd);
+    fd = -1;
+    num = cap = 0;
+    return ok;
+  }
+
+template <class T>
+  bool mmap_vector<T>::remap(size_type n)
+  {
+    if (fd < 0 || !writable) return false;
+    // 以页面为单位延长，多出的部分直接作为容量
+    size_type bytes = round_to_page(n);
+    if (ftruncate(fd, off_t(bytes)) != 0) return false;
+    // 新的映射建立成功后才解除原有的映射
+    iterator p = map_region(bytes);
+    if (!p) {
+      // 档案已延长，多出的部分在 close() 时截去
+      return false;
+    }
+    unmap();
+    start = p;
+    mapped = bytes;
+    cap = bytes / sizeof(value_type);
+    return true;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_MMAP_VECTOR_H_
@@ -0,0 +1,520 @@
+
+/**
+ * mpmc_queue / mpmc_segmented_queue
+ * 多生产者、多消费者(multi producer multi consumer)的并发队列。
+ *
+ * mpmc_queue 为有界的环形数组(Dmitry Vyukov 的算法)：
+ * 每个槽位带一个序号，生产者与消费者各自以 CAS 领取位置，
+ * 再由槽位序号判断该格是否可写 / 可读，双方不必互相等待，也不需要锁。
+ *   序号 == pos       可写入，写入后设为 pos + 1
+ *   序号 == pos + 1   可读出，读出后设为 pos + capacity，留给下一圈的生产者
+ * 批次操作先检查连续多格的序号，再以一次 CAS 领取整段。
+ *
+ * mpmc_segmented_queue 为无界的区块链表，做法与 deque 相同，以固定大小的区块存放元素；
+ * 生产者与消费者各持一把锁(two-lock queue)，彼此不争用，
+ * 消费完的区块暂存一块供生产者再利用。
+ *
+ * 两者都有不阻塞的 try_push / try_pop，以及满 / 空时休眠等待的 push / pop；
+ * 等待先短暂自旋，再以 condition variable 休眠，有执行绪等待时才发出通知。
+ *
+ * mpmc_queue 要求元素的复制构造不抛出异常，否则已领取的槽位无法发布。
+ */
+#ifndef TINYSTL_MPMC_QUEUE_H_
+#define TINYSTL_MPMC_QUEUE_H_
+
+#include <new> // for placement new
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "alloc.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "construct.h"
+
+namespace tinystl
+{
+
+enum
+{
+  __MPMC_LINE = 64,           // cache line 的大小
+  __MPMC_SPIN = 64,           // 休眠前重试的次数
+  __MPMC_BLOCK_BYTES = 4096   // mpmc_segmented_queue 的区块大小，超过 __MAX_BYTES，不经过内存池
+};
+
+// 满 / 空时的休眠与唤醒
+// 等待者先登记再重试，通知者发布元素后才检查登记数，两侧以 seq_cst fence 排序，不会遗失唤醒
+struct __mpmc_parking
+{
+  std::mutex m;
+  std::condition_variable cv;
+  std::atomic<size_t> waiters;
+
+  __mpmc_parking() : waiters(0) { }
+  // 没有等待者时只有一次 load
+  void notify_one()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) != 0) {
+      { std::lock_guard<std::mutex> lock(m); }
+      cv.notify_one();
+    }
+  }
+  void notify_all()
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) != 0) {
+      { std::lock_guard<std::mutex> lock(m); }
+      cv.notify_all();
+    }
+  }
+  // 以 lock 持有 m，登记后调用端重试一次，失败再 wait()
+  void enter() { waiters.fetch_add(1, std::memory_order_seq_cst); }
+  void leave() { waiters.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+
+/**
+ * mpmc_queue
+ */
+template <class T>
+  struct __mpmc_cell
+  {
+    std::atomic<size_t> seq;
+    alignas(T) char data[sizeof(T)];
+
+    T* value() { return reinterpret_cast<T*>(data); }
+  };
+
+template <class T, class Alloc = alloc>
+  class mpmc_queue
+  {
+    public:
+    typedef T                 value_type;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef size_t            size_type;
+
+    protected:
+    typedef __mpmc_cell<T>                  cell_type;
+    typedef simple_alloc<cell_type, Alloc>  cell_allocator;
+
+    cell_type* cells;
+    size_type mask;
+    char pad0[__MPMC_LINE];
+    std::atomic<size_type> enqueue_pos;
+    char pad1[__MPMC_LINE];
+    std::atomic<size_type> dequeue_pos;
+    char pad2[__MPMC_LINE];
+    __mpmc_parking not_empty;
+    __mpmc_parking not_full;
+
+    // 领取 pos 起至多 n 个连续可写 / 可读的槽位，传回个数，pos 为领取的起点
+    size_type claim_push(size_type& pos, size_type n);
+    size_type claim_pop(size_type& pos, size_type n);
+    // 读出 pos 的元素并交还槽位
+    void take(size_type pos, value_type& x)
+    {
+      cell_type* c = cells + (pos & mask);
+      try {
+        x = *c->value();
+      } catch(...) { // 元素遗失，但槽位仍须交还，否则队列卡住
+        tinystl::destroy(c->value());
+        c->seq.store(pos + mask + 1, std::memory_order_release);
+        throw;
+      }
+      tinystl::destroy(c->value());
+      c->seq.store(pos + mask + 1, std::memory_order_release);
+    }
+    // 不发出通知，供持有 parking 锁的等待循环使用，以免两把锁交叉持有
+    bool push_one(const value_type& x)
+    {
+      size_type pos;
+      if (claim_push(pos, 1) == 0)
+        return false;
+      cell_type* c = cells + (pos & mask);
+      construct(c->value(), x);
+      c->seq.store(pos + 1, std::memory_order_release);
+      return true;
+    }
+    bool pop_one(value_type& x)
+    {
+      size_type pos;
+      if (claim_pop(pos, 1) == 0)
+        return false;
+      take(pos, x);
+      return true;
+    }
+
+    private:
+    // 不可复制
+    mpmc_queue(const mpmc_queue&);
+    mpmc_queue& operator=(const mpmc_queue&);
+
+    public:
+    // 容量向上取至 2 的幂
+    explicit mpmc_queue(size_type n) : enqueue_pos(0), dequeue_pos(0)
+    {
+      size_type cap = 2;
+      while (cap < n) cap <<= 1;
+      cells = cell_allocator::allocate(cap);
+      mask = cap - 1;
+      for (size_type i = 0; i < cap; ++i) {
+        new (&cells[i].seq) std::atomic<size_t>(i);
+      }
+    }
+    ~mpmc_queue()
+    {
+      const size_type t = enqueue_pos.load(std::memory_order_relaxed);
+      for (size_type pos = dequeue_pos.load(std::memory_order_relaxed); pos != t; ++pos)
+        tinystl::destroy(cells[pos & mask].value());
+      cell_allocator::deallocate(cells, mask + 1);
+    }
+
+    size_type capacity() const { return mask + 1; }
+    // 并发操作时只是近似值
+    size_type size() const
+    {
+      const size_type h = dequeue_pos.load(std::memory_order_acquire);
+      const size_type t = enqueue_pos.load(std::memory_order_acquire);
+      return t > h ? t - h : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    // 已满时传回 false
+    bool try_push(const value_type& x)
+    {
+      if (!push_one(x))
+        return false;
+      not_empty.notify_one();
+      return true;
+    }
+    // 为空时传回 false
+    bool try_pop(value_type& x)
+    {
+      if (!pop_one(x))
+        return false;
+      not_full.notify_one();
+      return true;
+    }
+    // 写入 first 起至多 n 个元素，传回实际写入的个数；整段只做一次 CAS
+    template <class InputIterator>
+      size_type try_push_n(InputIterator first, size_type n);
+    // 取出至多 n 个元素写至 result，传回实际取出的个数
+    template <class OutputIterator>
+      size_type try_pop_n(OutputIterator result, size_type n);
+
+    // 已满时等待
+    void push(const value_type& x);
+    // 为空时等待
+    void pop(value_type& x);
+  };
+
+template <class T, class Alloc>
+  typename mpmc_queue<T, Alloc>::size_type
+  mpmc_queue<T, Alloc>::claim_push(size_type& pos, size_type n)
+  {
+    pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      // 由 pos 起数出连续可写的格数
+      size_type k = 0;
+      for ( ; k < n; ++k) {
+        const size_type seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+        if (seq != pos + k) break;
+      }
+      if (k != 0) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+          return k;
+        // CAS 失败时 pos 已更新为最新值，重新检查
+      } else {
+        const size_type seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+        if (ptrdiff_t(seq - pos) < 0) // 上一圈的元素尚未被取走，已满
+          return 0;
+        pos = enqueue_pos.load(std::memory_order_relaxed); // 被其他生产者抢先
+      }
+    }
+  }
+
+template <class T, class Alloc>
+  typename mpmc_queue<T, Alloc>::size_type
+  mpmc_queue<T, Alloc>::claim_pop(size_type& pos, size_type n)
+  {
+    pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+      size_type k = 0;
+      for ( ; k < n; ++k) {
+        const size_type seq = cells[(pos + k) & mask].seq.load(std::memory_order_acquire);
+        if (seq != pos + k + 1) break;
+      }
+      if (k != 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed))
+          return k;
+      } else {
+        const size_type seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+        if (ptrdiff_t(seq - (pos + 1)) < 0) // 尚未写入，为空
+          return 0;
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+template <class T, class Alloc>
+  template <class InputIterator>
+  typename mpmc_queue<T, Alloc>::size_type
+  mpmc_queue<T, Alloc>::try_push_n(InputIterator first, size_type n)
+  {
+    size_type pos;
+    const size_type k = n == 0 ? 0 : claim_push(pos, n);
+    for (size_type i = 0; i < k; ++i, ++first) {
+      cell_type* c = cells + ((pos + i) & mask);
+      construct(c->value(), *first);
+      c->seq.store(pos + i + 1, std::memory_order_release);
+    }
+    if (k != 0) not_empty.notify_all();
+    return k;
+  }
+
+template <class T, class Alloc>
+  template <class OutputIterator>
+  typename mpmc_queue<T, Alloc>::size_type
+  mpmc_queue<T, Alloc>::try_pop_n(OutputIterator result, size_type n)
+  {
+    size_type pos;
+    const size_type k = n == 0 ? 0 : claim_pop(pos, n);
+    for (size_type i = 0; i < k; ++i, ++result)
+      take(pos + i, *result);
+    if (k != 0) not_full.notify_all();
+    return k;
+  }
+
+template <class T, class Alloc>
+  void mpmc_queue<T, Alloc>::push(const value_type& x)
+  {
+    for (int i = 0; i < __MPMC_SPIN; ++i)
+      if (try_push(x)) return;
+    {
+      std::unique_lock<std::mutex> lock(not_full.m);
+      not_full.enter();
+      while (!push_one(x))
+        not_full.cv.wait(lock);
+      not_full.leave();
+    }
+    not_empty.notify_one();
+  }
+
+template <class T, class Alloc>
+  void mpmc_queue<T, Alloc>::pop(value_type& x)
+  {
+    for (int i = 0; i < __MPMC_SPIN; ++i)
+      if (try_pop(x)) return;
+    {
+      std::unique_lock<std::mutex> lock(not_empty.m);
+      not_empty.enter();
+      while (!pop_one(x))
+        not_empty.cv.wait(lock);
+      not_empty.leave();
+    }
+    not_full.notify_one();
+  }
+
+
+/**
+ * mpmc_segmented_queue
+ */
+template <class T>
+  struct __mpmc_block
+  {
+    std::atomic<__mpmc_block*> next;
+    std::atomic<size_t> written;  // 已发布的元素个数，由生产者递增
+    size_t read;                  // 已取出的元素个数，只由消费者存取
+
+    // 区块约为 __MPMC_BLOCK_BYTES，至少放一个元素
+    static size_t capacity()
+    { return sizeof(T) < size_t(__MPMC_BLOCK_BYTES) ? size_t(__MPMC_BLOCK_BYTES) / sizeof(T) : size_t(1); }
+    static size_t bytes() { return sizeof(__mpmc_block) + capacity() * sizeof(T) + alignof(T); }
+    T* values()
+    {
+      size_t p = (size_t)(this + 1);
+      return (T*)((p + alignof(T) - 1) & ~(size_t)(alignof(T) - 1));
+    }
+  };
+
+template <class T, class Alloc = alloc>
+  class mpmc_segmented_queue
+  {
+    public:
+    typedef T                 value_type;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef size_t            size_type;
+
+    protected:
+    typedef __mpmc_block<T>           block_type;
+    typedef simple_alloc<char, Alloc> block_allocator;
+
+    // 消费者
+    std::mutex head_lock;
+    block_type* head;
+    char pad0[__MPMC_LINE];
+    // 生产者
+    std::mutex tail_lock;
+    block_type* tail;
+    char pad1[__MPMC_LINE];
+    std::atomic<block_type*> spare; // 消费完的区块暂存于此，供生产者再利用
+    __mpmc_parking not_empty;
+
+    // 区块大于 __MAX_BYTES，配置器直接交给 malloc()，可在多个执行绪间配置与释还
+    block_type* new_block()
+    {
+      block_type* b = spare.exchange(0, std::memory_order_acquire);
+      if (b == 0) {
+        b = (block_type*)block_allocator::allocate(block_type::bytes());
+        new (&b->next) std::atomic<block_type*>(0);
+        new (&b->written) std::atomic<size_t>(0);
+      } else {
+        b->next.store(0, std::memory_order_relaxed);
+        b->written.store(0, std::memory_order_relaxed);
+      }
+      b->read = 0;
+      return b;
+    }
+    void delete_block(block_type* b)
+    {
+      b = spare.exchange(b, std::memory_order_release);
+      if (b) block_allocator::deallocate((char*)b, block_type::bytes());
+    }
+    // 持有 tail_lock 时调用，写入一个元素但不通知
+    void push_locked(const value_type& x);
+    // 持有 head_lock 时调用
+    bool pop_locked(value_type& x);
+
+    private:
+    // 不可复制
+    mpmc_segmented_queue(const mpmc_segmented_queue&);
+    mpmc_segmented_queue& operator=(const mpmc_segmented_queue&);
+
+    public:
+    mpmc_segmented_queue() : spare(0)
+    {
+      head = tail = new_block();
+    }
+    ~mpmc_segmented_queue()
+    {
+      while (head) {
+        block_type* next = head->next.load(std::memory_order_relaxed);
+        tinystl::destroy(head->values() + head->read,
+                         head->values() + head->written.load(std::memory_order_relaxed));
+        block_allocator::deallocate((char*)head, block_type::bytes());
+        head = next;
+      }
+      if (block_type* b = spare.load(std::memory_order_relaxed))
+        block_allocator::deallocate((char*)b, block_type::bytes());
+    }
+
+    // 无界，永不阻塞
+    void push(const value_type& x)
+    {
+      {
+        std::lock_guard<std::mutex> lock(tail_lock);
+        push_locked(x);
+      }
+      not_empty.notify_one();
+    }
+    bool try_push(const value_type& x)
+    {
+      push(x);
+      return true;
+    }
+    // 整段在一次加锁内写入
+    template <class InputIterator>
+      void push_n(InputIterator first, size_type n)
+      {
+        if (n == 0) return;
+        {
+          std::lock_guard<std::mutex> lock(tail_lock);
+          for ( ; n != 0; --n, ++first)
+            push_locked(*first);
+        }
+        not_empty.notify_all();
+      }
+
+    // 为空时传回 false
+    bool try_pop(value_type& x)
+    {
+      std::lock_guard<std::mutex> lock(head_lock);
+      return pop_locked(x);
+    }
+    // 取出至多 n 个元素写至 result，传回实际取出的个数
+    template <class OutputIterator>
+      size_type try_pop_n(OutputIterator result, size_type n)
+      {
+        std::lock_guard<std::mutex> lock(head_lock);
+        size_type k = 0;
+        for ( ; k < n && pop_locked(*result); ++k)
+          ++result;
+        return k;
+      }
+    // 为空时等待
+    void pop(value_type& x)
+    {
+      for (int i = 0; i < __MPMC_SPIN; ++i)
+        if (try_pop(x)) return;
+      std::unique_lock<std::mutex> lock(not_empty.m);
+      not_empty.enter();
+      while (!try_pop(x))
+        not_empty.cv.wait(lock);
+      not_empty.leave();
+    }
+  };
+
+template <class T, class Alloc>
+  void mpmc_segmented_queue<T, Alloc>::push_locked(const value_type& x)
+  {
+    const size_type w = tail->written.load(std::memory_order_relaxed);
+    if (w != block_type::capacity()) {
+      construct(tail->values() + w, x);
+      tail->written.store(w + 1, std::memory_order_release);
+    } else { // 区块已满，元素写入新区块后才接上链表
+      block_type* b = new_block();
+      try {
+        construct(b->values(), x);
+      } catch(...) {
+        delete_block(b);
+        throw;
+      }
+      b->written.store(1, std::memory_order_relaxed);
+      // 接上之后生产者不再碰旧区块，消费者可随时将它释还
+      block_type* old = tail;
+      tail = b;
+      old->next.store(b, std::memory_order_release);
+    }
+  }
+
+template <class T, class Alloc>
+  bool mpmc_segmented_queue<T, Alloc>::pop_locked(value_type& x)
+  {
+    for (;;) {
+      if (head->read != block_type::capacity()) {
+        if (head->read == head->written.load(std::memory_order_acquire))
+          return false;
+        T* p = head->values() + head->read++;
+        try {
+          x = *p;
+        } catch(...) { // 元素遗失，但队列仍可使用
+          tinystl::destroy(p);
+          throw;
+        }
+        tinystl::destroy(p);
+        return true;
+      }
+      // 区块已取完，移至下一区块
+      block_type* next = head->next.load(std::memory_order_acquire);
+      if (next == 0)
+        return false;
+      delete_block(head);
+      head = next;
+    }
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_MPMC_QUEUE_H_
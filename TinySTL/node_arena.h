@@ -0,0 +1,195 @@
+
+/**
+ * node_arena
+ * 节点式容器(list / slist / rb_tree)的节点配置方式。
+ * 以 node_arena<Alloc> 作为容器的 Alloc 参数，容器便拥有自己的节点区(arena)：
+ *
+ *   list<int, node_arena<> > pending;
+ *   slist<msg, node_arena<malloc_alloc> > outbox;
+ *
+ * 节点区向 Alloc 一次配置一整块(chunk)，依序切出节点，先后插入的节点在内存中也相邻，
+ * 走访时较少 cache miss；块的大小由 __ARENA_FIRST_NODES 起倍增，至 __ARENA_MAX_CHUNK_BYTES 为止。
+ * 删除的节点放入节点区自己的空闲链表，供之后的插入重用。
+ *
+ * clear() 不再逐一释还节点，而是一次将所有块归还节点区，元素有 trivial destructor 时
+ * 不必走访任何节点，为 O(chunks)。块留待重新填入时依序使用，不必再向 Alloc 配置，
+ * 也不会因 free() 将内存交还作业系统、再配置时重新 page fault；容器解构时才整块释还给 Alloc。
+ * 要在 clear() 之后立即释还内存，与一个空的容器 swap 即可。
+ *
+ * 节点属于配置它的容器。两个容器之间的 splice / merge 无法只改变串接，
+ * 改为在目的容器复制元素、再自来源删除，为 O(n)；同一个容器之内仍为 O(1)。
+ */
+#ifndef TINYSTL_NODE_ARENA_H_
+#define TINYSTL_NODE_ARENA_H_
+
+#include "alloc.h"
+#include "algobase.h"
+
+namespace tinystl
+{
+
+enum
+{
+  __ARENA_FIRST_NODES = 16,             // 第一块的节点数
+  __ARENA_MAX_CHUNK_BYTES = 64 * 1024   // 每块大小的上限
+};
+
+// 作为容器 Alloc 参数的标记，Alloc 为实际配置内存的配置器
+template <class Alloc = alloc>
+  struct node_arena
+  {
+    typedef Alloc base_allocator;
+  };
+
+// 每块的第一个节点存放块的资讯，节点至少有两个指针大，放得下
+struct __arena_chunk
+{
+  __arena_chunk* next;
+  size_t nodes;
+};
+// 空闲节点的串接方式，与第二级配置器的 obj 相同
+struct __arena_free_node
+{
+  __arena_free_node* next;
+};
+
+
+/**
+ * 容器的节点来源，容器以 protected 继承取得，一般配置器下不占空间
+ * allocate_node / deallocate_node     元素节点
+ * allocate_header / deallocate_header list、rb_tree 的 header，不属于节点区，clear() 后仍然有效
+ * release_nodes                       收回全部元素节点，元素必须已经解构
+ * shares_nodes                        x 的节点能否直接串接进来
+ */
+template <class Node, class Alloc>
+  class __node_storage
+  {
+    protected:
+    typedef simple_alloc<Node, Alloc>     node_allocator;
+
+    public:
+    enum { arena = false };
+
+    Node* allocate_node() { return node_allocator::allocate(); }
+    void deallocate_node(Node* p) { node_allocator::deallocate(p); }
+    Node* allocate_header() { return node_allocator::allocate(); }
+    void deallocate_header(Node* p) { node_allocator::deallocate(p); }
+    void release_nodes() { }
+    bool shares_nodes(const __node_storage&) const { return true; }
+    void swap_nodes(__node_storage&) { }
+  };
+
+template <class Node, class Alloc>
+  class __node_storage<Node, node_arena<Alloc> >
+  {
+    protected:
+    typedef simple_alloc<Node, Alloc>     node_allocator;
+
+    __arena_chunk* chunks;          // 使用中的块，新的在前
+    __arena_chunk* spare;           // release_nodes() 收回、尚未再使用的块
+    Node* cur;                      // 目前这一块尚未切出的第一个节点
+    Node* last;                     // 目前这一块的结尾
+    __arena_free_node* free_nodes;
+    size_t next_nodes;              // 下一块的节点数，含存放资讯的第一个节点
+
+    void init()
+    {
+      chunks = spare = 0;
+      cur = last = 0;
+      free_nodes = 0;
+      next_nodes = __ARENA_FIRST_NODES;
+    }
+    void new_chunk()
+    {
+      __arena_chunk* c = spare;
+      if (c)
+        spare = c->next;
+      else {
+        c = (__arena_chunk*)node_allocator::allocate(next_nodes);
+        c->nodes = next_nodes;
+        const size_t max_nodes = size_t(__ARENA_MAX_CHUNK_BYTES) / sizeof(Node);
+        if (next_nodes < max_nodes) next_nodes = tinystl::min(2 * next_nodes, max_nodes);
+      }
+      c->next = chunks;
+      chunks = c;
+      cur = (Node*)c + 1;
+      last = (Node*)c + c->nodes;
+    }
+    static void free_chunks(__arena_chunk* c)
+    {
+      while (c) {
+        __arena_chunk* next = c->next;
+        node_allocator::deallocate((Node*)c, c->nodes);
+        c = next;
+      }
+    }
+
+    public:
+    enum { arena = true };
+
+    __node_storage() { init(); }
+    // 复制容器时不复制节点区，新的容器有自己的节点区
+    __node_storage(const __node_storage&) { init(); }
+    __node_storage& operator=(const __node_storage&) { return *this; }
+    ~__node_storage()
+    {
+      free_chunks(chunks);
+      free_chunks(spare);
+    }
+
+    Node* allocate_node()
+    {
+      if (free_nodes) {
+        Node* p = (Node*)free_nodes;
+        free_nodes = free_nodes->next;
+        return p;
+      }
+      if (cur == last) new_chunk();
+      return cur++;
+    }
+    void deallocate_node(Node* p)
+    {
+      __arena_free_node* q = (__arena_free_node*)p;
+      q->next = free_nodes;
+      free_nodes = q;
+    }
+    Node* allocate_header() { return node_allocator::allocate(); }
+    void deallocate_header(Node* p) { node_allocator::deallocate(p); }
+    // 使用中的块全部移入 spare，依原本配置的先后排列，重新填入时依序使用
+    void release_nodes()
+    {
+      while (chunks) {
+        __arena_chunk* next = chunks->next;
+        chunks->next = spare;
+        spare = chunks;
+        chunks = next;
+      }
+      cur = last = 0;
+      free_nodes = 0;
+    }
+    bool shares_nodes(const __node_storage& x) const { return this == &x; }
+    void swap_nodes(__node_storage& x)
+    {
+      __node_storage tmp;
+      tmp.take(*this);
+      take(x);
+      x.take(tmp);
+    }
+
+    private:
+    // 取得 x 的全部节点，x 成为空的节点区
+    void take(__node_storage& x)
+    {
+      chunks = x.chunks;
+      spare = x.spare;
+      cur = x.cur;
+      last = x.last;
+      free_nodes = x.free_nodes;
+      next_nodes = x.next_nodes;
+      x.init();
+    }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_NODE_ARENA_H_
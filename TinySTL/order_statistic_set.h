@@ -0,0 +1,148 @@
+
+/**
+ * order_statistic_set
+ * 可依名次存取的 set：以 rb_subtree_size 增强的 rb_tree，每个节点记录子树的元素个数。
+ *   nth(k)    第 k 小的元素(由 0 起算)，k >= size() 时为 end()，O(log n)
+ *   rank(x)   小于 x 的元素个数，O(log n)
+ * 例如 99 百分位数为 s.nth(s.size() * 99 / 100)，不需走访前面的元素。
+ * 其余介面与 set 相同，键值不重复；元素不可经由迭代器修改。
+ */
+#ifndef TINYSTL_ORDER_STATISTIC_SET_H_
+#define TINYSTL_ORDER_STATISTIC_SET_H_
+
+#include "alloc.h"
+#include "pair.h"
+#include "function.h"
+#include "tree.h"
+
+namespace tinystl
+{
+
+// rb_tree 的增强：子树的元素个数
+struct rb_subtree_size
+{
+  typedef size_t meta_type;
+
+  template <class Value>
+    static void update(meta_type& m, const Value&, const meta_type* left, const meta_type* right)
+    {
+      m = 1 + (left ? *left : 0) + (right ? *right : 0);
+    }
+};
+
+template <class Key, class Compare = less<Key>, class Alloc = alloc>
+  class order_statistic_set
+  {
+    public:
+    typedef Key            key_type;
+    typedef Key            value_type;
+    typedef Compare        key_compare;
+    typedef Compare        value_compare;
+
+    private:
+    typedef rb_tree<key_type, value_type, identity<value_type>, key_compare, Alloc,
+                    rb_subtree_size> rep_type;
+    typedef typename rep_type::link_type          link_type;
+    typedef typename rep_type::iterator           rep_iterator;
+    rep_type t;
+
+    public:
+    typedef typename rep_type::const_iterator     iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::const_reference    reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    private:
+    static size_type subtree_size(__rb_tree_node_base* x) { return x ? ((link_type)x)->meta : 0; }
+    static rep_iterator to_rep(iterator i) { return rep_iterator((link_type)i.node); }
+
+    public:
+    // 构造
+    order_statistic_set() : t(Compare()) { }
+    explicit order_statistic_set(const Compare& comp) : t(comp) { }
+    template <class InputIterator>
+      order_statistic_set(InputIterator first, InputIterator last) : t(Compare())
+      { t.insert_unique(first, last); }
+    template <class InputIterator>
+      order_statistic_set(InputIterator first, InputIterator last, const Compare& comp) : t(comp)
+      { t.insert_unique(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    value_compare value_comp() const { return t.key_comp(); }
+    iterator begin() const { return t.begin(); }
+    iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    void swap(order_statistic_set& x) { t.swap(x.t); }
+
+    // 插入、删除
+    pair<iterator, bool> insert(const value_type& x)
+    {
+      pair<rep_iterator, bool> p = t.insert_unique(x);
+      return pair<iterator, bool>(p.first, p.second);
+    }
+    iterator insert(iterator position, const value_type& x) { return t.insert_unique(to_rep(position), x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+    // 以已排序、不重复的 [first, last) 取代原有内容，O(n)
+    template <class ForwardIterator>
+      void assign_sorted(ForwardIterator first, ForwardIterator last) { t.assign_sorted(first, last); }
+    void erase(iterator position) { t.erase(to_rep(position)); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(iterator first, iterator last) { t.erase(to_rep(first), to_rep(last)); }
+    void clear() { t.clear(); }
+
+    // 搜寻
+    iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+    // 依名次存取
+    iterator nth(size_type k) const;
+    size_type rank(const key_type& x) const;
+  };
+
+template <class Key, class Compare, class Alloc>
+  typename order_statistic_set<Key, Compare, Alloc>::iterator
+  order_statistic_set<Key, Compare, Alloc>::nth(size_type k) const
+  {
+    link_type x = t.__root();
+    while (x != 0) {
+      const size_type left = subtree_size(x->left);
+      if (k < left)
+        x = (link_type)x->left;
+      else if (k == left)
+        return iterator(x);
+      else { // 略过左子树与 x 本身
+        k -= left + 1;
+        x = (link_type)x->right;
+      }
+    }
+    return end();
+  }
+
+template <class Key, class Compare, class Alloc>
+  typename order_statistic_set<Key, Compare, Alloc>::size_type
+  order_statistic_set<Key, Compare, Alloc>::rank(const key_type& k) const
+  {
+    const key_compare comp = key_comp();
+    size_type result = 0;
+    link_type x = t.__root();
+    while (x != 0)
+      if (comp(x->value_field, k)) { // x 与其左子树都小于 k
+        result += subtree_size(x->left) + 1;
+        x = (link_type)x->right;
+      } else
+        x = (link_type)x->left;
+    return result;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_ORDER_STATISTIC_SET_H_
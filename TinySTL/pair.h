@@ -0,0 +1,43 @@
+
+/**
+ * pair
+ * 将两个数据组合为一个整体
+ * rb_tree 的 insert_unique() 与区间适配器 zip / enumerate 都以它作为返回值
+ */
+#ifndef TINYSTL_PAIR_H_
+#define TINYSTL_PAIR_H_
+
+namespace tinystl
+{
+
+template <class T1, class T2>
+  struct pair
+  {
+    typedef T1     first_type;
+    typedef T2     second_type;
+
+    T1 first;
+    T2 second;
+
+    pair() : first(T1()), second(T2()) { }
+    pair(const T1& a, const T2& b) : first(a), second(b) { }
+    // 允许由可转换的 pair 构造
+    template <class U1, class U2>
+      pair(const pair<U1, U2>& p) : first(p.first), second(p.second) { }
+  };
+
+template <class T1, class T2>
+  inline bool operator==(const pair<T1, T2>& x, const pair<T1, T2>& y)
+  { return x.first == y.first && x.second == y.second; }
+
+template <class T1, class T2>
+  inline bool operator<(const pair<T1, T2>& x, const pair<T1, T2>& y)
+  { return x.first < y.first || (!(y.first < x.first) && x.second < y.second); }
+
+template <class T1, class T2>
+  inline pair<T1, T2> make_pair(const T1& x, const T2& y)
+  { return pair<T1, T2>(x, y); }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_PAIR_H_
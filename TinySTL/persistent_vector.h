@@ -0,0 +1,509 @@
+
+/**
+ * persistent_vector
+ * 不可变(immutable)的 vector，各版本之间共用结构(structural sharing)。
+ *
+ * 元素存放于 32 叉的 trie，叶节点各放 32 个元素；最后不满 32 个的元素另放在 tail，
+ * 因此 push_back() 多半只复制 tail，每 32 次才碰到 trie。
+ *   复制(快照)：O(1)，只增加 root 与 tail 的引用计数
+ *   operator[]：O(log32 n)，十亿个元素也只有 6 层
+ *   push_back() / set() / pop_back()：O(log32 n)，传回新版本，只复制由 root 至目标的路径
+ *
+ * transient_vector 用于批次修改：引用计数为 1 的节点直接原地修改，
+ * 只有与其他版本共用的节点才复制，完成后以 persistent() 转回。
+ *
+ * 节点以引用计数管理，经由配置器 Alloc 配置。
+ * 与 alloc 相同，不考虑多线程：跨线程传递快照须由使用者自行同步。
+ * 只支援尾端的增删，不支援 RRB-tree 的 concat / slice。
+ */
+#ifndef TINYSTL_PERSISTENT_VECTOR_H_
+#define TINYSTL_PERSISTENT_VECTOR_H_
+
+#include "alloc.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace tinystl
+{
+
+enum
+{
+  __PVEC_BITS = 5,
+  __PVEC_WIDTH = 1 << __PVEC_BITS, // 每个节点的分支数
+  __PVEC_MASK = __PVEC_WIDTH - 1
+};
+
+// 节点共同的头部
+struct __pvec_node
+{
+  size_t refs;    // 引用计数
+  size_t count;   // 叶节点：已构造的元素个数
+  bool leaf;
+};
+
+struct __pvec_inner : public __pvec_node
+{
+  __pvec_node* child[__PVEC_WIDTH];
+};
+
+template <class T>
+  struct __pvec_leaf : public __pvec_node
+  {
+    alignas(T) char data[__PVEC_WIDTH * sizeof(T)];
+
+    T* values() { return reinterpret_cast<T*>(data); }
+    const T* values() const { return reinterpret_cast<const T*>(data); }
+  };
+
+template <class T, class Alloc>
+  class __pvec_base;
+
+// 唯读迭代器，保存目前所在叶节点，连续走访时每 32 个元素才下降一次 trie
+template <class T, class Alloc>
+  struct __pvec_iterator
+  {
+    typedef __pvec_iterator<T, Alloc>     self;
+    typedef __pvec_base<T, Alloc>         vector_type;
+
+    typedef random_access_iterator_tag    iterator_category;
+    typedef T                             value_type;
+    typedef const T*                      pointer;
+    typedef const T&                      reference;
+    typedef ptrdiff_t                     difference_type;
+
+    const vector_type* vec;
+    size_t index;
+    const T* block; // index 所在叶节点的元素
+
+    __pvec_iterator(const vector_type* v, size_t i) : vec(v), index(i) { set_block(); }
+    __pvec_iterator() : vec(0), index(0), block(0) { }
+
+    void set_block() { block = index < vec->size() ? vec->leaf_for(index)->values() : 0; }
+
+    reference operator*() const { return block[index & __PVEC_MASK]; }
+    pointer operator->() const { return &(operator*()); }
+    reference operator[](difference_type n) const { return (*vec)[index + n]; }
+    self& operator++()
+    {
+      if ((++index & __PVEC_MASK) == 0) set_block();
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    // end() 不在任何叶节点上(block 为 0)，由它后退时也要重新取得叶节点
+    self& operator--()
+    {
+      if ((index-- & __PVEC_MASK) == 0 || block == 0) set_block();
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+    self& operator+=(difference_type n)
+    {
+      index += n;
+      set_block();
+      return *this;
+    }
+    self& operator-=(difference_type n) { return *this += -n; }
+    self operator+(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp += n;
+    }
+    self operator-(difference_type n) const
+    {
+      self tmp = *this;
+      return tmp -= n;
+    }
+    difference_type operator-(const self& x) const { return difference_type(index - x.index); }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return index < x.index; }
+  };
+
+
+/**
+ * __pvec_base
+ * persistent_vector 与 transient_vector 共同的表示法。
+ * 所有修改都以 editable() 取得可写的节点：引用计数为 1 时就是节点本身，
+ * 否则复制一份并放弃对原节点的引用，所以由 root 往下逐层处理即完成路径复制。
+ */
+template <class T, class Alloc>
+  class __pvec_base
+  {
+    friend struct __pvec_iterator<T, Alloc>;
+
+    public:
+    typedef T                             value_type;
+    typedef const value_type&             const_reference;
+    typedef const value_type&             reference;
+    typedef size_t                        size_type;
+    typedef ptrdiff_t                     difference_type;
+    typedef __pvec_iterator<T, Alloc>     const_iterator;
+    typedef __pvec_iterator<T, Alloc>     iterator;
+
+    protected:
+    typedef __pvec_node                             node;
+    typedef __pvec_inner                            inner;
+    typedef __pvec_leaf<T>                          leaf;
+    typedef simple_alloc<inner, Alloc>              inner_allocator;
+    typedef simple_alloc<leaf, Alloc>               leaf_allocator;
+
+    size_type cnt;
+    size_type shift; // root 所在层的位移量，trie 只有一层时为 __PVEC_BITS
+    node* root;      // 只含 tail 时为 0
+    leaf* tail;      // 空的 vector 为 0
+
+    // 节点管理
+    static inner* new_inner()
+    {
+      inner* p = inner_allocator::allocate();
+      p->refs = 1;
+      p->count = 0;
+      p->leaf = false;
+      for (int i = 0; i < __PVEC_WIDTH; ++i) p->child[i] = 0;
+      return p;
+    }
+    static leaf* new_leaf()
+    {
+      leaf* p = leaf_allocator::allocate();
+      p->refs = 1;
+      p->count = 0;
+      p->leaf = true;
+      return p;
+    }
+    static void retain(node* p) { if (p) ++p->refs; }
+    static void release(node* p);
+    static node* copy_node(node* p);
+    static node* editable(node* p)
+    {
+      if (p->refs == 1) return p;
+      node* q = copy_node(p);
+      --p->refs;
+      return q;
+    }
+    static leaf* editable(leaf* p) { return static_cast<leaf*>(editable(static_cast<node*>(p))); }
+
+    // trie 中最后一个元素之后的位置，其后的元素都在 tail
+    size_type tailoff() const { return cnt < __PVEC_WIDTH ? 0 : ((cnt - 1) >> __PVEC_BITS) << __PVEC_BITS; }
+    const leaf* leaf_for(size_type i) const
+    {
+      if (i >= tailoff()) return tail;
+      const node* p = root;
+      for (size_type level = shift; level > 0; level -= __PVEC_BITS)
+        p = static_cast<const inner*>(p)->child[(i >> level) & __PVEC_MASK];
+      return static_cast<const leaf*>(p);
+    }
+
+    static node* new_path(size_type level, node* p);
+    node* push_tail(size_type level, node* parent, leaf* full_tail);
+    node* pop_tail(size_type level, node* p);
+    static node* do_assoc(size_type level, node* p, size_type i, const T& x);
+
+    // 修改：由 persistent_vector 施于副本，由 transient_vector 施于自身
+    void do_push_back(const T& x);
+    void do_pop_back();
+    void do_set(size_type i, const T& x);
+    void swap_rep(__pvec_base& x)
+    {
+      size_type n = cnt; cnt = x.cnt; x.cnt = n;
+      n = shift; shift = x.shift; x.shift = n;
+      node* r = root; root = x.root; x.root = r;
+      leaf* t = tail; tail = x.tail; x.tail = t;
+    }
+
+    __pvec_base() : cnt(0), shift(__PVEC_BITS), root(0), tail(0) { }
+    __pvec_base(const __pvec_base& x) : cnt(x.cnt), shift(x.shift), root(x.root), tail(x.tail)
+    {
+      retain(root);
+      retain(tail);
+    }
+    ~__pvec_base()
+    {
+      release(root);
+      release(tail);
+    }
+    __pvec_base& operator=(const __pvec_base& x)
+    {
+      __pvec_base tmp(x);
+      swap_rep(tmp);
+      return *this;
+    }
+
+    public:
+    size_type size() const { return cnt; }
+    bool empty() const { return cnt == 0; }
+    const_reference operator[](size_type i) const { return leaf_for(i)->values()[i & __PVEC_MASK]; }
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return tail->values()[tail->count - 1]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, cnt); }
+  };
+
+template <class T, class Alloc>
+  void __pvec_base<T, Alloc>::release(node* p)
+  {
+    if (!p || --p->refs != 0) return;
+    if (p->leaf) {
+      leaf* l = static_cast<leaf*>(p);
+      destroy(l->values(), l->values() + l->count);
+      leaf_allocator::deallocate(l);
+    } else {
+      inner* n = static_cast<inner*>(p);
+      for (int i = 0; i < __PVEC_WIDTH; ++i) release(n->child[i]);
+      inner_allocator::deallocate(n);
+    }
+  }
+
+template <class T, class Alloc>
+  __pvec_node* __pvec_base<T, Alloc>::copy_node(node* p)
+  {
+    if (p->leaf) {
+      const leaf* l = static_cast<const leaf*>(p);
+      leaf* q = new_leaf();
+      try {
+        tinystl::uninitialized_copy(l->values(), l->values() + l->count, q->values());
+      } catch(...) {
+        leaf_allocator::deallocate(q);
+        throw;
+      }
+      q->count = l->count;
+      return q;
+    }
+    const inner* n = static_cast<const inner*>(p);
+    inner* q = new_inner();
+    for (int i = 0; i < __PVEC_WIDTH; ++i) {
+      q->child[i] = n->child[i];
+      retain(q->child[i]);
+    }
+    return q;
+  }
+
+// 以一连串只有第一个子节点的内部节点，将 p 挂在第 level 层之下
+template <class T, class Alloc>
+  __pvec_node* __pvec_base<T, Alloc>::new_path(size_type level, node* p)
+  {
+    if (level == 0) return p;
+    inner* r = new_inner();
+    r->child[0] = new_path(level - __PVEC_BITS, p);
+    return r;
+  }
+
+// 将满的 tail 放入 trie，此时 cnt 尚未包含新元素
+template <class T, class Alloc>
+  __pvec_node* __pvec_base<T, Alloc>::push_tail(size_type level, node* parent, leaf* full_tail)
+  {
+    inner* r = static_cast<inner*>(parent ? editable(parent) : new_inner());
+    const size_type i = ((cnt - 1) >> level) & __PVEC_MASK;
+    if (level == __PVEC_BITS)
+      r->child[i] = full_tail;
+    else
+      r->child[i] = r->child[i] ? \
+                    push_tail(level - __PVEC_BITS, r->child[i], full_tail) : \
+                    new_path(level - __PVEC_BITS, full_tail);
+    return r;
+  }
+
+// 移除 trie 中最后一个叶节点，取代 p 的引用；整个子树变空时传回 0
+template <class T, class Alloc>
+  __pvec_node* __pvec_base<T, Alloc>::pop_tail(size_type level, node* p)
+  {
+    const size_type i = ((cnt - 2) >> level) & __PVEC_MASK;
+    inner* r = static_cast<inner*>(editable(p));
+    if (level > __PVEC_BITS)
+      r->child[i] = pop_tail(level - __PVEC_BITS, r->child[i]);
+    else {
+      release(r->child[i]);
+      r->child[i] = 0;
+    }
+    if (r->child[0] == 0) { // 子树已无任何叶节点
+      release(r);
+      return 0;
+    }
+    return r;
+  }
+
+template <class T, class Alloc>
+  __pvec_node* __pvec_base<T, Alloc>::do_assoc(size_type level, node* p, size_type i, const T& x)
+  {
+    node* r = editable(p);
+    if (level == 0)
+      static_cast<leaf*>(r)->values()[i & __PVEC_MASK] = x;
+    else {
+      inner* n = static_cast<inner*>(r);
+      const size_type j = (i >> level) & __PVEC_MASK;
+      n->child[j] = do_assoc(level - __PVEC_BITS, n->child[j], i, x);
+    }
+    return r;
+  }
+
+template <class T, class Alloc>
+  void __pvec_base<T, Alloc>::do_push_back(const T& x)
+  {
+    if (tail && tail->count == __PVEC_WIDTH) { // tail 已满，放入 trie 并另起新的 tail
+      leaf* t = new_leaf();
+      try {
+        construct(t->values(), x);
+      } catch(...) {
+        leaf_allocator::deallocate(t);
+        throw;
+      }
+      t->count = 1;
+      try {
+        if ((cnt >> __PVEC_BITS) > (size_type(1) << shift)) { // root 已满，增加一层
+          inner* r = new_inner();
+          r->child[0] = root;
+          r->child[1] = new_path(shift, tail);
+          root = r;
+          shift += __PVEC_BITS;
+        } else
+          root = push_tail(shift, root, tail);
+      } catch(...) {
+        release(t);
+        throw;
+      }
+      tail = t;
+    } else {
+      tail = tail ? editable(tail) : new_leaf();
+      construct(tail->values() + tail->count, x);
+      ++tail->count;
+    }
+    ++cnt;
+  }
+
+template <class T, class Alloc>
+  void __pvec_base<T, Alloc>::do_pop_back()
+  {
+    if (cnt == 1) {
+      release(tail);
+      tail = 0;
+      cnt = 0;
+      return;
+    }
+    if (tail->count > 1) {
+      tail = editable(tail);
+      --tail->count;
+      destroy(tail->values() + tail->count);
+      --cnt;
+      return;
+    }
+    // tail 只剩一个元素：trie 最后一个叶节点成为新的 tail
+    leaf* new_tail = const_cast<leaf*>(leaf_for(cnt - 2));
+    retain(new_tail);
+    node* new_root = pop_tail(shift, root);
+    if (new_root && shift > __PVEC_BITS && static_cast<inner*>(new_root)->child[1] == 0) { // 减少一层
+      node* c = static_cast<inner*>(new_root)->child[0];
+      retain(c);
+      release(new_root);
+      new_root = c;
+      shift -= __PVEC_BITS;
+    }
+    release(tail);
+    tail = new_tail;
+    root = new_root;
+    --cnt;
+  }
+
+template <class T, class Alloc>
+  void __pvec_base<T, Alloc>::do_set(size_type i, const T& x)
+  {
+    if (i >= tailoff()) {
+      tail = editable(tail);
+      tail->values()[i & __PVEC_MASK] = x;
+    } else
+      root = do_assoc(shift, root, i, x);
+  }
+
+
+template <class T, class Alloc>
+  class transient_vector;
+
+/**
+ * persistent_vector
+ * 所有修改都是 const 成员函数，传回新版本，原版本不变
+ */
+template <class T, class Alloc = alloc>
+  class persistent_vector : public __pvec_base<T, Alloc>
+  {
+    friend class transient_vector<T, Alloc>;
+    typedef __pvec_base<T, Alloc> base;
+
+    public:
+    typedef typename base::size_type size_type;
+
+    persistent_vector() { }
+    persistent_vector(size_type n, const T& x);
+
+    persistent_vector push_back(const T& x) const
+    {
+      persistent_vector r(*this);
+      r.do_push_back(x);
+      return r;
+    }
+    persistent_vector pop_back() const
+    {
+      persistent_vector r(*this);
+      r.do_pop_back();
+      return r;
+    }
+    persistent_vector set(size_type i, const T& x) const
+    {
+      persistent_vector r(*this);
+      r.do_set(i, x);
+      return r;
+    }
+    // 批次修改
+    transient_vector<T, Alloc> transient() const { return transient_vector<T, Alloc>(*this); }
+    void swap(persistent_vector& x) { this->swap_rep(x); }
+  };
+
+/**
+ * transient_vector
+ * 原地修改的版本，与其他版本共用的节点在第一次修改时复制
+ */
+template <class T, class Alloc = alloc>
+  class transient_vector : public __pvec_base<T, Alloc>
+  {
+    typedef __pvec_base<T, Alloc> base;
+
+    public:
+    typedef typename base::size_type size_type;
+
+    transient_vector() { }
+    explicit transient_vector(const persistent_vector<T, Alloc>& v) : base(v) { }
+
+    void push_back(const T& x) { this->do_push_back(x); }
+    void pop_back() { this->do_pop_back(); }
+    void set(size_type i, const T& x) { this->do_set(i, x); }
+    // 交出内容，*this 变为空的
+    persistent_vector<T, Alloc> persistent()
+    {
+      persistent_vector<T, Alloc> r;
+      this->swap_rep(r);
+      return r;
+    }
+    void swap(transient_vector& x) { this->swap_rep(x); }
+  };
+
+template <class T, class Alloc>
+  persistent_vector<T, Alloc>::persistent_vector(size_type n, const T& x)
+  {
+    transient_vector<T, Alloc> t;
+    for ( ; n > 0; --n)
+      t.push_back(x);
+    this->swap_rep(t);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_PERSISTENT_VECTOR_H_
@@ -6,6 +6,7 @@
 
 #include "heap.h"
 #include "deque.h"
+#include "vector.h"
 #include "algobase.h"
 #include "function.h"
 
@@ -19,7 +20,13 @@ namespace tinystl
  * 
  * container adapter
  */
-template <class T, class Sequence = deque<T> >
+template <class T, class Sequence = deque<T> > class queue;
+template <class T, class Sequence>
+  bool operator==(const queue<T, Sequence>& x, const queue<T, Sequence>& y);
+template <class T, class Sequence>
+  bool operator<(const queue<T, Sequence>& x, const queue<T, Sequence>& y);
+
+template <class T, class Sequence>
   class queue
   {
     friend bool operator==<>(const queue& x, const queue& y);
@@ -32,10 +39,13 @@ template <class T, class Sequence = deque<T> >
     protected:
     Sequence c; // 底层容器
     public:
+    queue() : c() { }
+    // 以既有的容器构造，例如指定容量的 circular_buffer
+    explicit queue(const Sequence& s) : c(s) { }
     bool empty() const { return c.empty(); }
     size_type size() const { return c.size(); }
     reference front() { return c.front(); }
-    const_reference front() const { return c.front; }
+    const_reference front() const { return c.front(); }
     reference back() { return c.back(); }
     const_reference back() const { return c.back(); }
     void push(const value_type& x) { c.push_back(x); }
@@ -75,11 +85,11 @@ template <class T, class Sequence = vector<T>, class Compare = less<typename Seq
     template <class InputIterator>
       priority_queue(InputIterator first, InputIterator last, const Compare& x)
       : c(first, last), comp(x)
-      { make_heap(c.begin(), c.end(), comp); }
+      { tinystl::make_heap(c.begin(), c.end(), comp); }
     template <class InputIterator>
-      priority_queue(InputIterator first, InputIterator last, const Compare& x)
+      priority_queue(InputIterator first, InputIterator last)
       : c(first, last)
-      { make_heap(c.begin(), c.end()， comp); }
+      { tinystl::make_heap(c.begin(), c.end(), comp); }
     
     bool empty() const { return c.empty(); }
     size_type size() const { return c.size(); }
@@ -88,7 +98,7 @@ template <class T, class Sequence = vector<T>, class Compare = less<typename Seq
     {
       try {
         c.push_back(x);
-        push_heap(c.begin(), c.end(), comp);
+        tinystl::push_heap(c.begin(), c.end(), comp);
       } catch(...) {
         c.clear();
       }
@@ -96,7 +106,7 @@ template <class T, class Sequence = vector<T>, class Compare = less<typename Seq
     void pop()
     {
       try {
-        pop_heap(c.begin(), c.end(), comp);
+        tinystl::pop_heap(c.begin(), c.end(), comp);
         c.pop_back();
       } catch(...) {
         c.clear();
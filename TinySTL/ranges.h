@@ -0,0 +1,683 @@
+
+/**
+ * 惰性区间适配器(lazy range adaptors)
+ * transform / filter / take / drop / chunk / zip / enumerate
+ *
+ * 适配器只保存迭代器与函数对象，不配置任何内存，也不产生中间容器。
+ * 以 operator| 串接后，所有变换在遍历时的同一次走访中完成。
+ *   for (it = r.begin(); it != r.end(); ++it) ...
+ *   其中 r = views::all(vec) | views::filter(pred) | views::transform(f) | views::take(10)
+ *
+ * 每一个 view 都是 iterator_range<某种迭代器>，
+ * 迭代器的 category 由底层迭代器推得，Random Access 输入仍为 Random Access。
+ * 对 vector / deque / list / rb_tree 以及任何具有 iterator 型别与 begin()/end() 的区间都适用。
+ */
+#ifndef TINYSTL_RANGES_H_
+#define TINYSTL_RANGES_H_
+
+#include "pair.h"
+#include "iterator.h"
+#include "algobase.h"
+#include "construct.h"
+
+namespace tinystl
+{
+
+/**
+ * 编译期辅助工具
+ */
+template <bool cond, class Then, class Else>
+  struct __select { typedef Then type; };
+template <class Then, class Else>
+  struct __select<false, Then, Else> { typedef Else type; };
+
+template <class T> struct __remove_reference { typedef T type; };
+template <class T> struct __remove_reference<T&> { typedef T type; };
+template <class T> struct __remove_const { typedef T type; };
+template <class T> struct __remove_const<const T> { typedef T type; };
+
+template <class T> T& __declval();
+
+// 区间的迭代器型别，const 区间取 const_iterator
+template <class Range>
+  struct __range_iterator { typedef typename Range::iterator type; };
+template <class Range>
+  struct __range_iterator<const Range> { typedef typename Range::const_iterator type; };
+
+// 五种 tag 以继承表达强弱关系，能隐式转换为 Base 的 Derived 不弱于 Base
+template <class Base, class Derived>
+  struct __is_base_category
+  {
+    static char test(Base);
+    static long test(...);
+    enum { value = sizeof(test(Derived())) == sizeof(char) };
+  };
+// 取两种迭代器 category 中较弱的一种
+template <class Category1, class Category2>
+  struct __min_category
+  {
+    typedef typename __select<__is_base_category<Category1, Category2>::value,
+                              Category1,
+                              Category2>::type type;
+  };
+
+// 函数对象的外壳
+// lambda 没有 copy assignment，以解构后重新构造的方式使迭代器可被赋值
+template <class Function>
+  struct __function_box
+  {
+    Function f;
+
+    __function_box(const Function& x) : f(x) { }
+    __function_box(const __function_box& x) : f(x.f) { }
+    __function_box& operator=(const __function_box& x)
+    {
+      if (this != &x) {
+        destroy(&f);
+        construct(&f, x.f);
+      }
+      return *this;
+    }
+  };
+
+// 前进至多 n 步，不越过 last；n 小于 0 时视为 0
+template <class InputIterator, class Distance>
+  inline InputIterator __bounded_advance(InputIterator first, InputIterator last, Distance n,
+                                         input_iterator_tag)
+  {
+    for ( ; n > 0 && first != last; --n) ++first;
+    return first;
+  }
+template <class RandomAccessIterator, class Distance>
+  inline RandomAccessIterator __bounded_advance(RandomAccessIterator first, RandomAccessIterator last, Distance n,
+                                                random_access_iterator_tag)
+  {
+    if (n <= 0) return first;
+    return first + min(Distance(last - first), n);
+  }
+
+
+/**
+ * iterator_range
+ * 一对迭代器，所有 view 的共同外形
+ */
+template <class Iterator>
+  class iterator_range
+  {
+    public:
+    typedef Iterator                                                iterator;
+    typedef Iterator                                                const_iterator;
+    typedef typename iterator_traits<Iterator>::value_type          value_type;
+    typedef typename iterator_traits<Iterator>::reference           reference;
+    typedef typename iterator_traits<Iterator>::difference_type     difference_type;
+    typedef size_t                                                  size_type;
+
+    protected:
+    Iterator first;
+    Iterator last;
+
+    public:
+    iterator_range(const Iterator& f, const Iterator& l) : first(f), last(l) { }
+
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+    bool empty() const { return first == last; }
+    // 对非 Random Access 迭代器需走访一遍
+    size_type size() const { return size_type(distance(first, last)); }
+  };
+
+template <class Iterator>
+  inline iterator_range<Iterator> make_range(Iterator first, Iterator last)
+  {
+    return iterator_range<Iterator>(first, last);
+  }
+
+
+/**
+ * transform_iterator
+ * 解参考时才调用 f，category 与底层迭代器相同
+ */
+template <class Iterator, class Function>
+  struct transform_iterator
+  {
+    typedef transform_iterator<Iterator, Function>                                  self;
+
+    typedef typename iterator_traits<Iterator>::iterator_category                   iterator_category;
+    typedef decltype(__declval<const Function>()(*__declval<Iterator>()))          reference;
+    typedef typename __remove_const<
+            typename __remove_reference<reference>::type>::type                     value_type;
+    typedef value_type*                                                             pointer;
+    typedef typename iterator_traits<Iterator>::difference_type                     difference_type;
+
+    Iterator cur;
+    __function_box<Function> fun;
+
+    transform_iterator(const Iterator& x, const Function& f) : cur(x), fun(f) { }
+
+    reference operator*() const { return fun.f(*cur); }
+    self& operator++() { ++cur; return *this; }
+    self operator++(int) { self tmp = *this; ++cur; return tmp; }
+    self& operator--() { --cur; return *this; }
+    self operator--(int) { self tmp = *this; --cur; return tmp; }
+    // 随机存取，仅在底层为 Random Access 时可用
+    self& operator+=(difference_type n) { cur += n; return *this; }
+    self& operator-=(difference_type n) { cur -= n; return *this; }
+    self operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+    self operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+    difference_type operator-(const self& x) const { return cur - x.cur; }
+    reference operator[](difference_type n) const { return fun.f(cur[n]); }
+
+    bool operator==(const self& x) const { return cur == x.cur; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+    bool operator<(const self& x) const { return cur < x.cur; }
+  };
+
+
+/**
+ * filter_iterator
+ * 跳过不满足 pred 的元素，最多为 Bidirectional
+ */
+template <class Iterator, class Predicate>
+  struct filter_iterator
+  {
+    typedef filter_iterator<Iterator, Predicate>                         self;
+
+    typedef typename __min_category<
+            typename iterator_traits<Iterator>::iterator_category,
+            bidirectional_iterator_tag>::type                            iterator_category;
+    typedef typename iterator_traits<Iterator>::value_type               value_type;
+    typedef typename iterator_traits<Iterator>::pointer                  pointer;
+    typedef typename iterator_traits<Iterator>::reference                reference;
+    typedef typename iterator_traits<Iterator>::difference_type          difference_type;
+
+    Iterator cur;
+    Iterator last; // 底层区间的尾，向前搜寻的边界
+    __function_box<Predicate> pred;
+
+    filter_iterator(const Iterator& x, const Iterator& l, const Predicate& p)
+    : cur(x), last(l), pred(p)
+    { satisfy(); }
+
+    // 停在第一个满足 pred 的元素上
+    void satisfy()
+    {
+      while (cur != last && !pred.f(*cur)) ++cur;
+    }
+
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      ++cur;
+      satisfy();
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    // 前方必定存在满足 pred 的元素，否则行为未定义
+    self& operator--()
+    {
+      do --cur; while (!pred.f(*cur));
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const self& x) const { return cur == x.cur; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+  };
+
+
+/**
+ * take_iterator
+ * 计数迭代器，用于非 Random Access 的 take
+ * 计数用尽或底层迭代器到达尾端时，与尾端迭代器相等
+ */
+template <class Iterator>
+  struct take_iterator
+  {
+    typedef take_iterator<Iterator>                                      self;
+
+    typedef typename __min_category<
+            typename iterator_traits<Iterator>::iterator_category,
+            forward_iterator_tag>::type                                  iterator_category;
+    typedef typename iterator_traits<Iterator>::value_type               value_type;
+    typedef typename iterator_traits<Iterator>::pointer                  pointer;
+    typedef typename iterator_traits<Iterator>::reference                reference;
+    typedef typename iterator_traits<Iterator>::difference_type          difference_type;
+
+    Iterator cur;
+    difference_type remaining; // 尚可走访的元素个数
+
+    take_iterator(const Iterator& x, difference_type n) : cur(x), remaining(n) { }
+
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      ++cur;
+      --remaining;
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const self& x) const { return remaining == x.remaining || cur == x.cur; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+  };
+
+// take 的结果型别由底层迭代器 category 决定
+// Random Access 直接截断区间，不引入新迭代器
+template <class Iterator,
+          class Category = typename iterator_traits<Iterator>::iterator_category>
+  struct __take_view
+  {
+    typedef iterator_range<take_iterator<Iterator> >                 type;
+    typedef typename iterator_traits<Iterator>::difference_type      difference_type;
+
+    static type make(const Iterator& first, const Iterator& last, difference_type n)
+    {
+      return type(take_iterator<Iterator>(first, n < 0 ? 0 : n),
+                  take_iterator<Iterator>(last, 0));
+    }
+  };
+template <class Iterator>
+  struct __take_view<Iterator, random_access_iterator_tag>
+  {
+    typedef iterator_range<Iterator>                                 type;
+    typedef typename iterator_traits<Iterator>::difference_type      difference_type;
+
+    static type make(const Iterator& first, const Iterator& last, difference_type n)
+    {
+      return type(first, __bounded_advance(first, last, n, random_access_iterator_tag()));
+    }
+  };
+
+
+/**
+ * chunk_iterator
+ * 每次解参考得到长度为 n 的子区间（最后一段可能较短）
+ */
+template <class Iterator>
+  struct chunk_iterator
+  {
+    typedef chunk_iterator<Iterator>                                     self;
+
+    typedef typename __min_category<
+            typename iterator_traits<Iterator>::iterator_category,
+            forward_iterator_tag>::type                                  iterator_category;
+    typedef iterator_range<Iterator>                                     value_type;
+    typedef value_type*                                                  pointer;
+    typedef value_type                                                   reference;
+    typedef typename iterator_traits<Iterator>::difference_type          difference_type;
+
+    Iterator cur;  // 本段的头
+    Iterator next; // 本段的尾，即下一段的头
+    Iterator last;
+    difference_type n;
+
+    chunk_iterator(const Iterator& x, const Iterator& l, difference_type sz)
+    : cur(x), next(x), last(l), n(sz)
+    { next = advance_chunk(cur); }
+
+    Iterator advance_chunk(const Iterator& x) const
+    {
+      return __bounded_advance(x, last, n, typename iterator_traits<Iterator>::iterator_category());
+    }
+
+    reference operator*() const { return reference(cur, next); }
+    self& operator++()
+    {
+      cur = next;
+      next = advance_chunk(cur);
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const self& x) const { return cur == x.cur; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+  };
+
+
+/**
+ * zip_iterator
+ * 同步走访两个区间，解参考得到 pair<reference1, reference2>
+ * 较短的区间结束时整体结束
+ */
+template <class Iterator1, class Iterator2>
+  struct zip_iterator
+  {
+    typedef zip_iterator<Iterator1, Iterator2>                           self;
+    typedef iterator_traits<Iterator1>                                   traits1;
+    typedef iterator_traits<Iterator2>                                   traits2;
+
+    typedef typename __min_category<
+            typename traits1::iterator_category,
+            typename traits2::iterator_category>::type                   iterator_category;
+    typedef pair<typename traits1::value_type,
+                 typename traits2::value_type>                           value_type;
+    typedef pair<typename traits1::reference,
+                 typename traits2::reference>                            reference;
+    typedef value_type*                                                  pointer;
+    typedef typename traits1::difference_type                           difference_type;
+
+    Iterator1 first;
+    Iterator2 second;
+
+    zip_iterator(const Iterator1& x, const Iterator2& y) : first(x), second(y) { }
+
+    reference operator*() const { return reference(*first, *second); }
+    self& operator++() { ++first; ++second; return *this; }
+    self operator++(int) { self tmp = *this; ++*this; return tmp; }
+    self& operator--() { --first; --second; return *this; }
+    self operator--(int) { self tmp = *this; --*this; return tmp; }
+    self& operator+=(difference_type n) { first += n; second += n; return *this; }
+    self& operator-=(difference_type n) { first -= n; second -= n; return *this; }
+    self operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+    self operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+    difference_type operator-(const self& x) const { return first - x.first; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    // 任一分量相等即视为相等，使较短区间的尾端成为整体尾端
+    bool operator==(const self& x) const { return first == x.first || second == x.second; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+    bool operator<(const self& x) const { return first < x.first; }
+  };
+
+// 尾端截至较短的长度，使 operator-- 与 operator- 得到对应的两个元素
+// 只能单向走访时不会后退，直接以两个尾端组成
+template <class Iterator1, class Iterator2>
+  inline zip_iterator<Iterator1, Iterator2>
+  __zip_end(const Iterator1&, const Iterator1& last1, const Iterator2&, const Iterator2& last2,
+            input_iterator_tag)
+  {
+    return zip_iterator<Iterator1, Iterator2>(last1, last2);
+  }
+// Bidirectional 需同步走访一遍，找出较短区间结束的位置
+template <class Iterator1, class Iterator2>
+  inline zip_iterator<Iterator1, Iterator2>
+  __zip_end(Iterator1 first1, const Iterator1& last1, Iterator2 first2, const Iterator2& last2,
+            bidirectional_iterator_tag)
+  {
+    for ( ; first1 != last1 && first2 != last2; ++first1, ++first2)
+      ;
+    return zip_iterator<Iterator1, Iterator2>(first1, first2);
+  }
+template <class Iterator1, class Iterator2>
+  inline zip_iterator<Iterator1, Iterator2>
+  __zip_end(const Iterator1& first1, const Iterator1& last1, const Iterator2& first2, const Iterator2& last2,
+            random_access_iterator_tag)
+  {
+    typename iterator_traits<Iterator1>::difference_type n = min(last1 - first1,
+                                                                 typename iterator_traits<Iterator1>::difference_type(last2 - first2));
+    return zip_iterator<Iterator1, Iterator2>(first1 + n, first2 + n);
+  }
+
+
+/**
+ * enumerate_iterator
+ * 解参考得到 pair<index, reference>，category 与底层迭代器相同
+ */
+template <class Iterator>
+  struct enumerate_iterator
+  {
+    typedef enumerate_iterator<Iterator>                                 self;
+
+    typedef typename iterator_traits<Iterator>::iterator_category        iterator_category;
+    typedef typename iterator_traits<Iterator>::difference_type          difference_type;
+    typedef pair<difference_type,
+                 typename iterator_traits<Iterator>::value_type>         value_type;
+    typedef pair<difference_type,
+                 typename iterator_traits<Iterator>::reference>          reference;
+    typedef value_type*                                                  pointer;
+
+    Iterator cur;
+    difference_type index;
+
+    enumerate_iterator(const Iterator& x, difference_type i) : cur(x), index(i) { }
+
+    reference operator*() const { return reference(index, *cur); }
+    self& operator++() { ++cur; ++index; return *this; }
+    self operator++(int) { self tmp = *this; ++*this; return tmp; }
+    self& operator--() { --cur; --index; return *this; }
+    self operator--(int) { self tmp = *this; --*this; return tmp; }
+    self& operator+=(difference_type n) { cur += n; index += n; return *this; }
+    self& operator-=(difference_type n) { cur -= n; index -= n; return *this; }
+    self operator+(difference_type n) const { self tmp = *this; return tmp += n; }
+    self operator-(difference_type n) const { self tmp = *this; return tmp -= n; }
+    difference_type operator-(const self& x) const { return cur - x.cur; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bool operator==(const self& x) const { return cur == x.cur; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+    bool operator<(const self& x) const { return cur < x.cur; }
+  };
+
+
+/**
+ * 适配器对象
+ * 每个适配器提供 result<Iterator>::type 与 operator()(first, last)，
+ * 由 operator| 将左侧区间的 begin()/end() 交给它
+ */
+namespace views
+{
+
+template <class Container>
+  inline iterator_range<typename __range_iterator<Container>::type> all(Container& c)
+  {
+    return iterator_range<typename __range_iterator<Container>::type>(c.begin(), c.end());
+  }
+
+template <class Function>
+  struct __transform_adaptor
+  {
+    Function f;
+    explicit __transform_adaptor(const Function& x) : f(x) { }
+
+    template <class Iterator>
+      struct result { typedef iterator_range<transform_iterator<Iterator, Function> > type; };
+
+    template <class Iterator>
+      typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+      {
+        return typename result<Iterator>::type(transform_iterator<Iterator, Function>(first, f),
+                                               transform_iterator<Iterator, Function>(last, f));
+      }
+  };
+template <class Function>
+  inline __transform_adaptor<Function> transform(const Function& f)
+  {
+    return __transform_adaptor<Function>(f);
+  }
+
+template <class Predicate>
+  struct __filter_adaptor
+  {
+    Predicate pred;
+    explicit __filter_adaptor(const Predicate& x) : pred(x) { }
+
+    template <class Iterator>
+      struct result { typedef iterator_range<filter_iterator<Iterator, Predicate> > type; };
+
+    template <class Iterator>
+      typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+      {
+        return typename result<Iterator>::type(filter_iterator<Iterator, Predicate>(first, last, pred),
+                                               filter_iterator<Iterator, Predicate>(last, last, pred));
+      }
+  };
+template <class Predicate>
+  inline __filter_adaptor<Predicate> filter(const Predicate& pred)
+  {
+    return __filter_adaptor<Predicate>(pred);
+  }
+
+struct __take_adaptor
+{
+  ptrdiff_t n;
+  explicit __take_adaptor(ptrdiff_t x) : n(x) { }
+
+  template <class Iterator>
+    struct result { typedef typename __take_view<Iterator>::type type; };
+
+  template <class Iterator>
+    typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+    {
+      return __take_view<Iterator>::make(first, last, n);
+    }
+};
+inline __take_adaptor take(ptrdiff_t n)
+{
+  return __take_adaptor(n);
+}
+
+// drop 在构造时前进 n 步，此后不再有额外开销
+struct __drop_adaptor
+{
+  ptrdiff_t n;
+  explicit __drop_adaptor(ptrdiff_t x) : n(x) { }
+
+  template <class Iterator>
+    struct result { typedef iterator_range<Iterator> type; };
+
+  template <class Iterator>
+    typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+    {
+      return typename result<Iterator>::type(__bounded_advance(first, last, n, iterator_category(first)),
+                                             last);
+    }
+};
+inline __drop_adaptor drop(ptrdiff_t n)
+{
+  return __drop_adaptor(n);
+}
+
+struct __chunk_adaptor
+{
+  ptrdiff_t n;
+  // 大小不足 1 的块视为 1，否则 chunk_iterator 永远停在原地
+  explicit __chunk_adaptor(ptrdiff_t x) : n(x > 0 ? x : 1) { }
+
+  template <class Iterator>
+    struct result { typedef iterator_range<chunk_iterator<Iterator> > type; };
+
+  template <class Iterator>
+    typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+    {
+      return typename result<Iterator>::type(chunk_iterator<Iterator>(first, last, n),
+                                             chunk_iterator<Iterator>(last, last, n));
+    }
+};
+// n 不大于 0 时视为 1
+inline __chunk_adaptor chunk(ptrdiff_t n)
+{
+  return __chunk_adaptor(n);
+}
+
+struct __enumerate_adaptor
+{
+  template <class Iterator>
+    struct result { typedef iterator_range<enumerate_iterator<Iterator> > type; };
+
+  // 尾端的 index 不参与比较，但 --end() 与 operator- 会用到。
+  // 只能前进的迭代器用不到，不必为此走访整个区间。
+  template <class Iterator>
+    typename result<Iterator>::type operator()(const Iterator& first, const Iterator& last) const
+    {
+      typedef enumerate_iterator<Iterator> iter;
+      return typename result<Iterator>::type(iter(first, 0),
+                                             iter(last, __enumerate_end_index(first, last, iterator_category(first))));
+    }
+
+  template <class Iterator>
+    static ptrdiff_t __enumerate_end_index(const Iterator&, const Iterator&, input_iterator_tag)
+    { return 0; }
+  template <class Iterator>
+    static ptrdiff_t __enumerate_end_index(const Iterator& first, const Iterator& last, bidirectional_iterator_tag)
+    { return tinystl::distance(first, last); }
+};
+inline __enumerate_adaptor enumerate()
+{
+  return __enumerate_adaptor();
+}
+
+// 右侧区间以迭代器保存，zip 本身不持有容器
+template <class Iterator2>
+  struct __zip_adaptor
+  {
+    Iterator2 first2;
+    Iterator2 last2;
+    __zip_adaptor(const Iterator2& f, const Iterator2& l) : first2(f), last2(l) { }
+
+    template <class Iterator1>
+      struct result { typedef iterator_range<zip_iterator<Iterator1, Iterator2> > type; };
+
+    template <class Iterator1>
+      typename result<Iterator1>::type operator()(const Iterator1& first1, const Iterator1& last1) const
+      {
+        typedef zip_iterator<Iterator1, Iterator2> iter;
+        typedef typename iter::iterator_category category;
+        return typename result<Iterator1>::type(iter(first1, first2),
+                                                __zip_end(first1, last1, first2, last2, category()));
+      }
+  };
+// r1 | zip(r2)
+template <class Range2>
+  inline __zip_adaptor<typename __range_iterator<Range2>::type> zip(Range2& r2)
+  {
+    return __zip_adaptor<typename __range_iterator<Range2>::type>(r2.begin(), r2.end());
+  }
+template <class Range2>
+  inline __zip_adaptor<typename Range2::const_iterator> zip(const Range2& r2)
+  {
+    return __zip_adaptor<typename Range2::const_iterator>(r2.begin(), r2.end());
+  }
+// zip(r1, r2)
+template <class Range1, class Range2>
+  inline iterator_range<zip_iterator<typename __range_iterator<Range1>::type,
+                                     typename __range_iterator<Range2>::type> >
+  zip(Range1& r1, Range2& r2)
+  {
+    return zip(r2)(r1.begin(), r1.end());
+  }
+
+/**
+ * operator|
+ * 左侧为容器或 view（可为暂时对象），const 容器以 const_iterator 走访
+ * 不是适配器的右侧型别没有 result<>，经 SFINAE 排除
+ */
+template <class Range, class Adaptor>
+  inline typename Adaptor::template result<typename __range_iterator<Range>::type>::type
+  operator|(Range& r, const Adaptor& adaptor)
+  {
+    return adaptor(r.begin(), r.end());
+  }
+template <class Range, class Adaptor>
+  inline typename Adaptor::template result<typename Range::const_iterator>::type
+  operator|(const Range& r, const Adaptor& adaptor)
+  {
+    return adaptor(r.begin(), r.end());
+  }
+
+} // namespace views
+
+} // namespace tinystl
+
+#endif // !TINYSTL_RANGES_H_
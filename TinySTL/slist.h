@@ -1,11 +1,22 @@
 /**
  * 单向链表 slist，不在标准规格中
  * 迭代器属于 Forward Iterator
+ *
+ * 只能在某个位置之后插入、删除(insert_after / erase_after / splice_after)，
+ * 某个位置之前的操作需先以 previous() 由头走访，为 O(n)。
+ * 两个选项以模板参数开启，缺省都关闭，每个节点始终只有一个指针：
+ *   TrackTail   记录最后一个节点，push_back() / back() 为 O(1)
+ *   CacheSize   记录元素个数，size() 为 O(1)；但由另一个 slist 接合区间时需走访该区间
+ * Alloc 为 node_arena<> 时，节点来自 slist 自己的节点区，见 node_arena.h
  */
 #ifndef TINYSTL_SLIST_H_
 #define TINYSTL_SLIST_H_
 
 #include "alloc.h"
+#include "iterator.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "node_arena.h"
 
 namespace tinystl
 {
@@ -16,7 +27,7 @@ struct __slist_node_base
   __slist_node_base* next;
 };
 template <class T>
-  struct __slist_node : public __slist_nade_base
+  struct __slist_node : public __slist_node_base
   {
     T data;
   };
@@ -36,6 +47,67 @@ inline size_t __slist_size(__slist_node_base* node)
     ++result;
   return result;
 }
+// 由 head 走访，找出 node 的前一个节点
+inline __slist_node_base* __slist_previous(__slist_node_base* head, const __slist_node_base* node)
+{
+  while (head && head->next != node)
+    head = head->next;
+  return head;
+}
+// 将 (before_first, before_last] 移至 pos 之后
+inline void __slist_splice_after(__slist_node_base* pos,
+                                 __slist_node_base* before_first, __slist_node_base* before_last)
+{
+  if (pos != before_first && pos != before_last) {
+    __slist_node_base* first = before_first->next;
+    __slist_node_base* after = pos->next;
+    before_first->next = before_last->next;
+    pos->next = first;
+    before_last->next = after;
+  }
+}
+// 将以 0 结尾的链表逆向，传回新的第一个节点
+inline __slist_node_base* __slist_reverse(__slist_node_base* node)
+{
+  __slist_node_base* result = node;
+  node = node->next;
+  result->next = 0;
+  while (node) {
+    __slist_node_base* next = node->next;
+    node->next = result;
+    result = node;
+    node = next;
+  }
+  return result;
+}
+// 合并两个已排序、以 0 结尾的链表，结果写回 a，相等时 a 的节点在前
+// 比较抛出异常时，a 仍串接着全部节点(次序不定)
+template <class Node>
+  void __slist_merge(__slist_node_base*& a, __slist_node_base* b)
+  {
+    __slist_node_base head;
+    __slist_node_base* tail = &head;
+    try {
+      while (a && b) {
+        if (static_cast<Node*>(b)->data < static_cast<Node*>(a)->data) {
+          tail->next = b;
+          b = b->next;
+        } else {
+          tail->next = a;
+          a = a->next;
+        }
+        tail = tail->next;
+      }
+    } catch(...) {
+      tail->next = a;
+      while (tail->next) tail = tail->next;
+      tail->next = b;
+      a = head.next;
+      throw;
+    }
+    tail->next = a ? a : b;
+    a = head.next;
+  }
 
 // slist 迭代器
 struct __slist_iterator_base
@@ -88,8 +160,8 @@ template <class T, class Ref, class Ptr>
   };
 
 // Slist
-template <class T, class Alloc = alloc>
-  class slist
+template <class T, class Alloc = alloc, bool TrackTail = false, bool CacheSize = false>
+  class slist : protected __node_storage<__slist_node<T>, Alloc>
   {
     public:
     typedef T                     value_type;
@@ -107,36 +179,103 @@ template <class T, class Alloc = alloc>
     typedef __slist_node<T>                    list_node;
     typedef __slist_node_base                  list_node_base;
     typedef __slist_iterator_base              iterator_base;
-    typedef simple_alloc<list_node, Alloc>     list_node_allocator;
+    typedef __node_storage<list_node, Alloc>   node_storage;
 
-    static list_node* create_node(const value_type& x)
+    list_node* create_node(const value_type& x)
     {
-      list_node* node = list_node_allocator::allocate();
+      list_node* node = this->allocate_node();
       try {
         construct(&node->data, x);
         node->next = 0;
       } catch (...) {
-        list_node_allocator::deallocate(node);
+        this->deallocate_node(node);
+        throw;
       }
       return node;
     }
 
-    static void destroy_node(list_node* node)
+    void destroy_node(list_node* node)
     {
       destroy(&node->data);
-      list_node_allocator::deallocate(node);
+      this->deallocate_node(node);
     }
+    // 解构全部元素，不释还节点
+    void destroy_values(__false_type)
+    {
+      for (list_node_base* p = head.next; p; p = p->next)
+        destroy(&((list_node*)p)->data);
+    }
+    void destroy_values(__true_type) { }
 
     private:
     list_node_base head;
+    list_node_base* tail;   // TrackTail 时为最后一个节点，空时为 &head
+    size_type length;       // CacheSize 时为元素个数
+
+    void empty_initialize()
+    {
+      head.next = 0;
+      tail = &head;
+      length = 0;
+    }
+    // 在 pos 之后串接节点 p
+    list_node_base* link_after(list_node_base* pos, list_node_base* p)
+    {
+      __slist_make_link(pos, p);
+      if (TrackTail && pos == tail) tail = p;
+      if (CacheSize) ++length;
+      return p;
+    }
+    // TrackTail 时重新找出最后一个节点
+    void reset_tail()
+    {
+      if (TrackTail) tail = __slist_previous(&head, 0);
+    }
+    list_node_base* before_begin_node() const { return const_cast<list_node_base*>(&head); }
 
     public:
-    slist() { head.next = 0; }
+    slist() { empty_initialize(); }
+    slist(size_type n, const value_type& x)
+    {
+      empty_initialize();
+      try {
+        insert_after(before_begin(), n, x);
+      } catch(...) {
+        clear();
+        throw;
+      }
+    }
+    slist(const slist& x)
+    {
+      empty_initialize();
+      try {
+        list_node_base* prev = &head;
+        for (const_iterator i = x.begin(); i != x.end(); ++i)
+          prev = link_after(prev, create_node(*i));
+      } catch(...) {
+        clear();
+        throw;
+      }
+    }
     ~slist() { clear(); }
+    slist& operator=(const slist& x)
+    {
+      if (this != &x) {
+        slist tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
 
+    iterator before_begin() { return iterator((list_node*)&head); }
+    const_iterator before_begin() const { return const_iterator((list_node*)before_begin_node()); }
     iterator begin() { return iterator((list_node*)head.next); }
+    const_iterator begin() const { return const_iterator((list_node*)head.next); }
     iterator end() { return iterator(0); }
-    size_type size() const { return __slist_size(head.next); }
+    const_iterator end() const { return const_iterator(0); }
+    // CacheSize 时为 O(1)，否则走访整个链表
+    size_type size() const { return CacheSize ? length : __slist_size(head.next); }
+    size_type max_size() const { return size_type(-1); }
     bool empty() const { return head.next == 0; }
 
     void swap(slist& L)
@@ -144,20 +283,256 @@ template <class T, class Alloc = alloc>
       list_node_base* tmp = head.next;
       head.next = L.head.next;
       L.head.next = tmp;
+      tmp = tail;
+      tail = L.tail == &L.head ? &head : L.tail;
+      L.tail = tmp == &head ? &L.head : tmp;
+      size_type n = length;
+      length = L.length;
+      L.length = n;
+      this->swap_nodes(L);
     }
 
     reference front() { return ((list_node*)head.next)->data; }
-    void push_front(const value_type& x) { __slist_make_link(&head, creat_node(x)); }
+    const_reference front() const { return ((list_node*)head.next)->data; }
+    // TrackTail 时为 O(1)，否则走访整个链表
+    reference back() { return ((list_node*)last_node())->data; }
+    const_reference back() const { return ((list_node*)last_node())->data; }
+
+    // position 的前一个位置，需由头走访，为 O(n)
+    iterator previous(const_iterator position)
+    { return iterator((list_node*)__slist_previous(&head, position.node)); }
+    const_iterator previous(const_iterator position) const
+    { return const_iterator((list_node*)__slist_previous(before_begin_node(), position.node)); }
+
+    void push_front(const value_type& x) { link_after(&head, create_node(x)); }
     void pop_front()
     {
       list_node* node = (list_node*) head.next;
       head.next = node->next;
+      if (TrackTail && tail == node) tail = &head;
+      if (CacheSize) --length;
       destroy_node(node);
     }
+    // TrackTail 时为 O(1)，否则走访整个链表
+    void push_back(const value_type& x) { link_after(last_node(), create_node(x)); }
+
+    // 在 position 之后插入，传回新元素的位置
+    iterator insert_after(iterator position, const value_type& x)
+    { return iterator((list_node*)link_after(position.node, create_node(x))); }
+    void insert_after(iterator position, size_type n, const value_type& x)
+    {
+      list_node_base* prev = position.node;
+      for ( ; n > 0; --n)
+        prev = link_after(prev, create_node(x));
+    }
+    // 移除 position 之后的元素，传回其后的位置
+    iterator erase_after(iterator position)
+    {
+      list_node* next = (list_node*)position.node->next;
+      position.node->next = next->next;
+      if (TrackTail && tail == next) tail = position.node;
+      if (CacheSize) --length;
+      destroy_node(next);
+      return iterator((list_node*)position.node->next);
+    }
+    // 移除 (before_first, last)，传回 last
+    iterator erase_after(iterator before_first, iterator last)
+    {
+      list_node_base* cur = before_first.node->next;
+      while (cur != last.node) {
+        list_node* tmp = (list_node*)cur;
+        cur = cur->next;
+        destroy_node(tmp);
+        if (CacheSize) --length;
+      }
+      before_first.node->next = last.node;
+      if (TrackTail && last.node == 0) tail = before_first.node;
+      return last;
+    }
+    // 使用 node_arena 时一次将节点全部归还节点区，元素有 trivial destructor 时为 O(chunks)
+    void clear()
+    {
+      if (node_storage::arena) {
+        typedef typename __type_traits<T>::has_trivial_destructor trivial_destructor;
+        destroy_values(trivial_destructor());
+        this->release_nodes();
+        empty_initialize();
+        return;
+      }
+      erase_after(before_begin(), end());
+    }
+
+    // 将 (before_first, before_last] 接合于 position 之后
+    // position 不能位于 (before_first, before_last] 之内；x 可以就是 *this
+    // 未开启 CacheSize 时为 O(1)
+    void splice_after(iterator position, slist& x, iterator before_first, iterator before_last)
+    {
+      if (before_first == before_last || position == before_first || position == before_last)
+        return;
+      if (!this->shares_nodes(x)) {
+        copy_after(position, x, before_first, before_last);
+        return;
+      }
+      if (CacheSize && &x != this) {
+        size_type n = 0;
+        for (list_node_base* p = before_first.node; p != before_last.node; p = p->next)
+          ++n;
+        x.length -= n;
+        length += n;
+      }
+      if (TrackTail) {
+        if (x.tail == before_last.node) x.tail = before_first.node;
+        if (tail == position.node) tail = before_last.node;
+      }
+      __slist_splice_after(position.node, before_first.node, before_last.node);
+    }
+    // 将 prev 之后的一个元素接合于 position 之后
+    void splice_after(iterator position, slist& x, iterator prev)
+    {
+      iterator i = prev;
+      splice_after(position, x, prev, ++i);
+    }
+    // 将 x 的全部元素接合于 position 之后，x 必须不同于 *this
+    // 未开启 TrackTail 时需找出 x 的最后一个节点，为 O(n)
+    void splice_after(iterator position, slist& x)
+    {
+      if (x.empty()) return;
+      list_node_base* last = x.last_node();
+      if (!this->shares_nodes(x)) {
+        copy_after(position, x, x.before_begin(), iterator((list_node*)last));
+        return;
+      }
+      if (TrackTail && tail == position.node) tail = last;
+      if (CacheSize) length += x.length;
+      __slist_splice_after(position.node, &x.head, last);
+      x.tail = &x.head;
+      x.length = 0;
+    }
+
+    void reverse()
+    {
+      if (head.next) {
+        if (TrackTail) tail = head.next;
+        head.next = __slist_reverse(head.next);
+      }
+    }
+    // 将 x 合并到 *this，两者必须先经过递增排序，稳定
+    void merge(slist& x);
+    // merge sort，只改变节点的串接，不配置任何空间，稳定
+    void sort();
+
+    private:
+    list_node_base* last_node() const
+    {
+      if (TrackTail) return tail;
+      return __slist_previous(before_begin_node(), 0);
+    }
+    // x 的节点属于另一个节点区时无法串接：
+    // 逐一将 (before_first, before_last] 的元素复制到 position 之后，再自 x 删除
+    void copy_after(iterator position, slist& x, iterator before_first, iterator before_last)
+    {
+      bool done;
+      do {
+        list_node_base* p = before_first.node->next;
+        done = p == before_last.node;
+        position = insert_after(position, ((list_node*)p)->data);
+        x.erase_after(before_first);
+      } while (!done);
+    }
   };
 
-} // namespace tinystl
+template <class T, class Alloc, bool TrackTail, bool CacheSize>
+  void slist<T, Alloc, TrackTail, CacheSize>::merge(slist& x)
+  {
+    if (this == &x || x.empty()) return;
+    list_node_base* b;
+    if (this->shares_nodes(x)) {
+      length += x.length;
+      x.length = 0;
+      b = x.head.next;
+      x.head.next = 0;
+      x.tail = &x.head;
+    } else {
+      // x 的节点属于另一个节点区，先复制成自己的节点再合并
+      list_node_base copies;
+      list_node_base* prev = &copies;
+      copies.next = 0;
+      size_type n = 0;
+      try {
+        for (const_iterator i = x.begin(); i != x.end(); ++i, ++n)
+          prev = prev->next = create_node(*i);
+      } catch(...) {
+        while (copies.next) {
+          list_node* p = (list_node*)copies.next;
+          copies.next = p->next;
+          destroy_node(p);
+        }
+        throw;
+      }
+      x.clear();
+      length += n;
+      b = copies.next;
+    }
+    try {
+      __slist_merge<list_node>(head.next, b);
+    } catch(...) {
+      reset_tail();
+      throw;
+    }
+    reset_tail();
+  }
 
-#endif // !TINYSTL_SLIST_H_
+template <class T, class Alloc, bool TrackTail, bool CacheSize>
+  void slist<T, Alloc, TrackTail, CacheSize>::sort()
+  {
+    if (head.next == 0 || head.next->next == 0)
+      return;
+    // 与 list::sort 相同，以 64 个子链表作为计数器：counter[i] 为 0 或 2^i 个已排序节点
+    // 编号较大的子链表所含的元素较早出现，合并时放在前面以保持稳定
+    list_node_base* counter[64];
+    int fill = 0;
+    list_node_base* rest = head.next;
+    list_node_base* carry = 0;
+    try {
+      while (rest) {
+        carry = rest;
+        rest = rest->next;
+        carry->next = 0;
+        int i = 0;
+        while (i < fill && counter[i]) {
+          list_node_base* b = carry;
+          carry = 0;
+          __slist_merge<list_node>(counter[i], b);
+          carry = counter[i];
+          counter[i++] = 0;
+        }
+        counter[i] = carry;
+        carry = 0;
+        if (i == fill) ++fill;
+      }
+      for (int i = 1; i < fill; ++i) {
+        list_node_base* b = counter[i - 1];
+        counter[i - 1] = 0;
+        if (counter[i]) __slist_merge<list_node>(counter[i], b);
+        else counter[i] = b;
+      }
+    } catch(...) {
+      // 将所有子链表重新串接回 *this，元素不会遗失
+      list_node_base* p = &head;
+      p->next = carry;
+      while (p->next) p = p->next;
+      for (int i = 0; i < fill; ++i) {
+        p->next = counter[i];
+        while (p->next) p = p->next;
+      }
+      p->next = rest;
+      reset_tail();
+      throw;
+    }
+    head.next = counter[fill - 1];
+    reset_tail();
+  }
 
+} // namespace tinystl
 
+#endif // !TINYSTL_SLIST_H_
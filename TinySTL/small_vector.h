@@ -0,0 +1,125 @@
+
+/**
+ * small_vector
+ * 前 N 个元素存放于对象内部的缓冲区，不经过配置器。
+ * 元素超过 N 个后与 vector 相同，按 Growth 扩充策略移往 heap。
+ * 移往 heap 后，只有 shrink_to_fit() 会使元素回到内部缓冲区。
+ *
+ * 迭代器为原生指针(Random Access Iterator)。
+ * 移动(move)位于 heap 上的 small_vector 只需交换三个指针。
+ */
+#ifndef TINYSTL_SMALL_VECTOR_H_
+#define TINYSTL_SMALL_VECTOR_H_
+
+#include "alloc.h"
+#include "construct.h"
+#include "type_traits.h"
+#include "vector.h" // for __vector_base
+
+namespace tinystl
+{
+
+// 前 N 个元素使用内部缓冲区，超过时向配置器要求
+template <class T, size_t N, class Alloc>
+  class __small_vector_storage
+  {
+    protected:
+    typedef simple_alloc<T, Alloc> data_allocator;
+    alignas(T) char buffer[N * sizeof(T)]; // 内部缓冲区
+
+    T* inline_storage() { return reinterpret_cast<T*>(buffer); }
+    const T* inline_storage() const { return reinterpret_cast<const T*>(buffer); }
+    T* allocate_storage(size_t& n)
+    {
+      if (n <= N) {
+        n = N;
+        return inline_storage();
+      }
+      return data_allocator::allocate(n);
+    }
+    void deallocate_storage(T* p, size_t n)
+    { // 内部缓冲区不归还配置器
+      if (p != inline_storage())
+        data_allocator::deallocate(p, n);
+    }
+  };
+
+template <class T, size_t N, class Alloc = alloc, class Growth = vector_growth_2x>
+  class small_vector : public __vector_base<T, __small_vector_storage<T, N, Alloc>, Growth>
+  {
+    // 不需要内部缓冲区时请使用 vector
+    static_assert(N > 0, "small_vector requires N > 0");
+
+    typedef __vector_base<T, __small_vector_storage<T, N, Alloc>, Growth> base;
+
+    public:
+    typedef typename base::size_type size_type;
+    typedef typename base::iterator  iterator;
+
+    protected:
+    void inline_initialize()
+    {
+      this->start = this->finish = this->inline_storage();
+      this->end_of_storage = this->start + N;
+    }
+    // 将 x 的元素搬移过来，x 变为空的 small_vector
+    // *this 不得持有元素，也不得持有 heap 上的空间
+    void steal(small_vector& x)
+    {
+      if (x.is_inline()) {
+        inline_initialize();
+        for (iterator cur = x.start; cur != x.finish; ++cur, ++this->finish)
+          new (this->finish) T(static_cast<T&&>(*cur));
+        tinystl::destroy(x.start, x.finish);
+      } else { // 位于 heap，直接接管
+        this->start = x.start;
+        this->finish = x.finish;
+        this->end_of_storage = x.end_of_storage;
+      }
+      x.inline_initialize();
+    }
+
+    public:
+    // 元素是否仍位于内部缓冲区
+    bool is_inline() const { return this->start == this->inline_storage(); }
+
+    // 构造函数
+    small_vector() { }
+    small_vector(size_type n, const T& value) { this->fill_initialize(n, value); }
+    explicit small_vector(size_type n) { this->fill_initialize(n, T()); }
+    small_vector(const small_vector& x)
+    { this->range_initialize(x.begin(), x.end(), random_access_iterator_tag()); }
+    small_vector(small_vector&& x) { steal(x); }
+    // 以区间 [first, last) 初始化，整数型别视为 (n, value)
+    template <class InputIterator>
+      small_vector(InputIterator first, InputIterator last)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        this->initialize_aux(first, last, integral());
+      }
+
+    small_vector& operator=(const small_vector& x)
+    {
+      if (this != &x) this->assign(x.begin(), x.end());
+      return *this;
+    }
+    small_vector& operator=(small_vector&& x)
+    {
+      if (this != &x) {
+        tinystl::destroy(this->start, this->finish);
+        this->deallocate();
+        steal(x);
+      }
+      return *this;
+    }
+    void swap(small_vector& x)
+    {
+      small_vector tmp(static_cast<small_vector&&>(x));
+      x = static_cast<small_vector&&>(*this);
+      *this = static_cast<small_vector&&>(tmp);
+    }
+  };
+
+} // namespace tinystl
+
+#endif // !TINYSTL_SMALL_VECTOR_H_
@@ -0,0 +1,375 @@
+
+/**
+ * soa_vector
+ * 结构数组(structure of arrays)：每个字段(field)各自存放于一段连续空间，
+ * 所有字段共用同一个 size 与 capacity。
+ * 只走访其中一两个字段的循环只会读取那几段空间，不浪费快取频宽。
+ *
+ *   soa_vector<int, double, int> v;  // {id, price, qty}
+ *   v.push_back(1, 9.5, 3);
+ *   double* price = v.data<1>();     // 64 bytes 对齐，可直接交给 SIMD 循环
+ *
+ * 所有字段以配置器一次配置，扩充策略与 vector 相同。
+ * 迭代器为 Random Access Iterator，解参考得到代理对象(proxy)，以 get<I>() 取得字段。
+ */
+#ifndef TINYSTL_SOA_VECTOR_H_
+#define TINYSTL_SOA_VECTOR_H_
+
+#include "alloc.h"
+#include "ranges.h"
+#include "vector.h" // for vector_growth_2x
+#include "iterator.h"
+#include "algobase.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace tinystl
+{
+
+enum { __SOA_ALIGN = 64 }; // 每个字段起始位置的对齐边界，一条 cache line
+
+inline size_t __soa_round_up(size_t bytes)
+{
+  return (bytes + __SOA_ALIGN - 1) & ~size_t(__SOA_ALIGN - 1);
+}
+
+// 第 I 个字段的型别
+template <size_t I, class Head, class... Tail>
+  struct __soa_field { typedef typename __soa_field<I - 1, Tail...>::type type; };
+template <class Head, class... Tail>
+  struct __soa_field<0, Head, Tail...> { typedef Head type; };
+
+/**
+ * __soa_columns
+ * 以继承串起各字段，第 I 层保存第 I 个字段的指针
+ * 所有操作逐层递归，对每个字段施以相同的动作
+ */
+template <size_t I, class... Fields>
+  struct __soa_columns
+  {
+    static size_t bytes(size_t) { return 0; }
+    void assign(char*, size_t) { }
+    void construct_at(size_t) { }
+    void construct_default(size_t) { }
+    void destroy_range(size_t, size_t) { }
+    void copy_to(__soa_columns&, size_t) const { }
+    void erase_at(size_t, size_t) { }
+  };
+template <size_t I, class Head, class... Tail>
+  struct __soa_columns<I, Head, Tail...> : public __soa_columns<I + 1, Tail...>
+  {
+    typedef __soa_columns<I + 1, Tail...> base;
+
+    Head* column;
+
+    __soa_columns() : column(0) { }
+
+    // n 个元素所需的空间，每个字段各自对齐
+    static size_t bytes(size_t n) { return __soa_round_up(n * sizeof(Head)) + base::bytes(n); }
+    void assign(char* p, size_t n)
+    {
+      column = (Head*)p;
+      base::assign(p + __soa_round_up(n * sizeof(Head)), n);
+    }
+    // 在第 i 个位置构造一列(row)，任一字段构造失败时析构已构造的字段
+    void construct_at(size_t i, const Head& x, const Tail&... rest)
+    {
+      tinystl::construct(column + i, x);
+      try {
+        base::construct_at(i, rest...);
+      } catch(...) {
+        tinystl::destroy(column + i);
+        throw;
+      }
+    }
+    void construct_default(size_t i)
+    {
+      tinystl::construct(column + i, Head());
+      try {
+        base::construct_default(i);
+      } catch(...) {
+        tinystl::destroy(column + i);
+        throw;
+      }
+    }
+    void destroy_range(size_t first, size_t last)
+    {
+      tinystl::destroy(column + first, column + last);
+      base::destroy_range(first, last);
+    }
+    // 将前 n 列复制到 dst 尚未构造的空间
+    void copy_to(__soa_columns& dst, size_t n) const
+    {
+      tinystl::uninitialized_copy(column, column + n, dst.column);
+      try {
+        base::copy_to(dst, n);
+      } catch(...) {
+        tinystl::destroy(dst.column, dst.column + n);
+        throw;
+      }
+    }
+    // 移除第 i 列，其后的列向前移动，size 为原有列数
+    void erase_at(size_t i, size_t size)
+    {
+      tinystl::copy(column + i + 1, column + size, column + i);
+      tinystl::destroy(column + size - 1);
+      base::erase_at(i, size);
+    }
+  };
+
+// 由第 I 层取出字段指针，Head 由基类推导
+template <size_t I, class Head, class... Tail>
+  inline Head* __soa_get(__soa_columns<I, Head, Tail...>& c) { return c.column; }
+template <size_t I, class Head, class... Tail>
+  inline const Head* __soa_get(const __soa_columns<I, Head, Tail...>& c) { return c.column; }
+
+
+/**
+ * __soa_reference
+ * 代表第 index 列的代理对象
+ */
+template <class SoA>
+  struct __soa_reference
+  {
+    SoA* soa;
+    size_t index;
+
+    __soa_reference(SoA* s, size_t i) : soa(s), index(i) { }
+
+    template <size_t I>
+      typename SoA::template field<I>::type& get() const { return soa->template data<I>()[index]; }
+  };
+
+// 逐列走访的迭代器，只保存容器指针与列号
+template <class SoA>
+  struct __soa_iterator
+  {
+    typedef __soa_iterator<SoA>              self;
+
+    typedef random_access_iterator_tag       iterator_category;
+    typedef __soa_reference<SoA>             value_type;
+    typedef __soa_reference<SoA>             reference;
+    typedef value_type*                      pointer;
+    typedef ptrdiff_t                        difference_type;
+
+    SoA* soa;
+    size_t index;
+
+    __soa_iterator(SoA* s, size_t i) : soa(s), index(i) { }
+
+    reference operator*() const { return reference(soa, index); }
+    reference operator[](difference_type n) const { return reference(soa, index + n); }
+    self& operator++() { ++index; return *this; }
+    self operator++(int) { self tmp = *this; ++index; return tmp; }
+    self& operator--() { --index; return *this; }
+    self operator--(int) { self tmp = *this; --index; return tmp; }
+    self& operator+=(difference_type n) { index += n; return *this; }
+    self& operator-=(difference_type n) { index -= n; return *this; }
+    self operator+(difference_type n) const { return self(soa, index + n); }
+    self operator-(difference_type n) const { return self(soa, index - n); }
+    difference_type operator-(const self& x) const { return difference_type(index - x.index); }
+
+    bool operator==(const self& x) const { return index == x.index; }
+    bool operator!=(const self& x) const { return index != x.index; }
+    bool operator<(const self& x) const { return index < x.index; }
+  };
+
+
+template <class Alloc, class... Fields>
+  class basic_soa_vector
+  {
+    public:
+    typedef size_t                                size_type;
+    typedef ptrdiff_t                             difference_type;
+    typedef __soa_reference<basic_soa_vector>     reference;
+    typedef __soa_iterator<basic_soa_vector>      iterator;
+
+    // 第 I 个字段的型别
+    template <size_t I>
+      struct field { typedef typename __soa_field<I, Fields...>::type type; };
+
+    protected:
+    typedef __soa_columns<0, Fields...>     columns_type;
+    typedef simple_alloc<char, Alloc>       data_allocator;
+
+    columns_type cols;
+    char* raw;          // 配置器交付的空间
+    size_type raw_size; // 配置的 bytes 数
+    size_type num;      // 列数
+    size_type cap;      // 可容纳的列数
+
+    static size_type storage_bytes(size_type n) { return columns_type::bytes(n) + __SOA_ALIGN; }
+    // 配置可容纳 n 列的空间，各字段对齐后记录于 new_cols，尚未构造任何元素
+    static char* allocate_columns(size_type n, columns_type& new_cols)
+    {
+      char* new_raw = data_allocator::allocate(storage_bytes(n));
+      char* aligned = (char*)(((size_t)new_raw + __SOA_ALIGN - 1) & ~size_t(__SOA_ALIGN - 1));
+      new_cols.assign(aligned, n);
+      return new_raw;
+    }
+    // 析构原有各列并释还空间，改用已复制好的新空间
+    void replace_storage(char* new_raw, const columns_type& new_cols, size_type n)
+    {
+      cols.destroy_range(0, num);
+      deallocate();
+      cols = new_cols;
+      raw = new_raw;
+      raw_size = storage_bytes(n);
+      cap = n;
+    }
+    // 配置可容纳 n 列的空间，并将原有各列搬移过去
+    void reallocate(size_type n);
+    void realloc_insert(const Fields&... values);
+    void deallocate()
+    {
+      if (raw) data_allocator::deallocate(raw, raw_size);
+    }
+    void grow_for(size_type n)
+    {
+      if (num + n > cap)
+        reallocate(vector_growth_2x::new_capacity(num, n, columns_type::bytes(1)));
+    }
+
+    public:
+    basic_soa_vector() : raw(0), raw_size(0), num(0), cap(0) { }
+    basic_soa_vector(const basic_soa_vector& x) : raw(0), raw_size(0), num(0), cap(0)
+    {
+      if (x.num != 0) {
+        reallocate(x.num);
+        x.cols.copy_to(cols, x.num);
+        num = x.num;
+      }
+    }
+    ~basic_soa_vector()
+    {
+      cols.destroy_range(0, num);
+      deallocate();
+    }
+    basic_soa_vector& operator=(const basic_soa_vector& x)
+    {
+      if (this != &x) {
+        basic_soa_vector tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(basic_soa_vector& x)
+    {
+      columns_type tmp_cols = cols; cols = x.cols; x.cols = tmp_cols;
+      char* tmp_raw = raw; raw = x.raw; x.raw = tmp_raw;
+      size_type tmp = raw_size; raw_size = x.raw_size; x.raw_size = tmp;
+      tmp = num; num = x.num; x.num = tmp;
+      tmp = cap; cap = x.cap; x.cap = tmp;
+    }
+
+    // 容量
+    size_type size() const { return num; }
+    size_type capacity() const { return cap; }
+    bool empty() const { return num == 0; }
+    void reserve(size_type n)
+    {
+      if (cap < n) reallocate(n);
+    }
+
+    // 字段存取
+    // 第 I 个字段的起始位置，对齐至 __SOA_ALIGN
+    template <size_t I>
+      typename field<I>::type* data() { return __soa_get<I>(cols); }
+    template <size_t I>
+      const typename field<I>::type* data() const { return __soa_get<I>(cols); }
+    // 第 I 个字段的整段区间，可直接交给算法或 ranges.h 的适配器
+    template <size_t I>
+      iterator_range<typename field<I>::type*> column()
+      { return iterator_range<typename field<I>::type*>(data<I>(), data<I>() + num); }
+    template <size_t I>
+      typename field<I>::type& get(size_type i) { return data<I>()[i]; }
+
+    // 逐列存取
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, num); }
+    reference operator[](size_type i) { return reference(this, i); }
+    reference front() { return reference(this, 0); }
+    reference back() { return reference(this, num - 1); }
+
+    // 元素操作
+    void push_back(const Fields&... values)
+    {
+      if (num != cap)
+        cols.construct_at(num, values...);
+      else // 无备用空间
+        realloc_insert(values...);
+      ++num;
+    }
+    void pop_back()
+    {
+      --num;
+      cols.destroy_range(num, num + 1);
+    }
+    iterator erase(iterator position)
+    {
+      cols.erase_at(position.index, num);
+      --num;
+      return position;
+    }
+    // 新增的列以各字段的 default constructor 构造
+    void resize(size_type n)
+    {
+      if (n < num) {
+        cols.destroy_range(n, num);
+        num = n;
+      } else {
+        grow_for(n - num);
+        for ( ; num < n; ++num)
+          cols.construct_default(num);
+      }
+    }
+    void clear()
+    {
+      cols.destroy_range(0, num);
+      num = 0;
+    }
+  };
+
+template <class Alloc, class... Fields>
+  void basic_soa_vector<Alloc, Fields...>::reallocate(size_type n)
+  {
+    columns_type new_cols;
+    char* new_raw = allocate_columns(n, new_cols);
+    try {
+      cols.copy_to(new_cols, num);
+    } catch(...) {
+      data_allocator::deallocate(new_raw, storage_bytes(n));
+      throw;
+    }
+    replace_storage(new_raw, new_cols, n);
+  }
+
+// 新的一列在新空间构造完成后才析构原有各列，values 可以参照容器内的元素
+template <class Alloc, class... Fields>
+  void basic_soa_vector<Alloc, Fields...>::realloc_insert(const Fields&... values)
+  {
+    const size_type n = vector_growth_2x::new_capacity(num, 1, columns_type::bytes(1));
+    columns_type new_cols;
+    char* new_raw = allocate_columns(n, new_cols);
+    try {
+      cols.copy_to(new_cols, num);
+      try {
+        new_cols.construct_at(num, values...);
+      } catch(...) {
+        new_cols.destroy_range(0, num);
+        throw;
+      }
+    } catch(...) {
+      data_allocator::deallocate(new_raw, storage_bytes(n));
+      throw;
+    }
+    replace_storage(new_raw, new_cols, n);
+  }
+
+// 以预设配置器使用的 soa_vector
+template <class... Fields>
+  using soa_vector = basic_soa_vector<alloc, Fields...>;
+
+} // namespace tinystl
+
+#endif // !TINYSTL_SOA_VECTOR_H_
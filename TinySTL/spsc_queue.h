@@ -0,0 +1,204 @@
+
+/**
+ * spsc_queue
+ * 单一生产者、单一消费者(single producer single consumer)的有界环形队列。
+ * 生产者与消费者各在一个执行绪，双方都不必加锁，每个操作在有限步内完成(wait-free)。
+ *
+ * 容量取至 2 的幂，head / tail 为不断递增的计数，槽位为计数 & mask；
+ * tail - head 即元素个数，不必浪费一个槽位区分满与空。
+ * head 与 tail 各占一条 cache line，并各自保存对方计数的快取：
+ * 生产者只在快取显示已满时才读取 head，消费者只在快取显示为空时才读取 tail，
+ * 平时两个执行绪不互相读写对方的 cache line。
+ *
+ * 介面与 queue 相同(push / front / pop)，但 push 在满时传回 false。
+ * push / push_n 只能由生产者调用，front / pop / pop_n 只能由消费者调用。
+ */
+#ifndef TINYSTL_SPSC_QUEUE_H_
+#define TINYSTL_SPSC_QUEUE_H_
+
+#include <atomic>
+#include "alloc.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace tinystl
+{
+
+enum { __SPSC_LINE = 64 }; // cache line 的大小
+
+template <class T, class Alloc = alloc>
+  class spsc_queue
+  {
+    public:
+    typedef T                 value_type;
+    typedef value_type*       pointer;
+    typedef value_type&       reference;
+    typedef const value_type& const_reference;
+    typedef size_t            size_type;
+
+    protected:
+    typedef simple_alloc<value_type, Alloc> data_allocator;
+
+    // 以填充字节隔开，三组成员不会落在同一条 cache line
+    // 唯读，两端共享
+    T* buf;
+    size_type mask;
+    char pad0[__SPSC_LINE];
+    // 生产者
+    std::atomic<size_type> tail; // 下一个写入的计数
+    size_type head_cache; // 生产者最后看到的 head
+    char pad1[__SPSC_LINE];
+    // 消费者
+    std::atomic<size_type> head; // 下一个读出的计数
+    size_type tail_cache; // 消费者最后看到的 tail
+    char pad2[__SPSC_LINE];
+
+    size_type capacity_() const { return mask + 1; }
+    // 生产者端：可写入的槽位数，快取不足 n 时才重新读取 head
+    size_type free_slots(size_type t, size_type n)
+    {
+      size_type free = capacity_() - (t - head_cache);
+      if (free < n) {
+        head_cache = head.load(std::memory_order_acquire);
+        free = capacity_() - (t - head_cache);
+      }
+      return free;
+    }
+    // 消费者端：可读出的元素数，快取不足 n 时才重新读取 tail
+    size_type ready_slots(size_type h, size_type n)
+    {
+      size_type ready = tail_cache - h;
+      if (ready < n) {
+        tail_cache = tail.load(std::memory_order_acquire);
+        ready = tail_cache - h;
+      }
+      return ready;
+    }
+
+    private:
+    // 不可复制
+    spsc_queue(const spsc_queue&);
+    spsc_queue& operator=(const spsc_queue&);
+
+    public:
+    // 容量向上取至 2 的幂
+    explicit spsc_queue(size_type n)
+    : tail(0), head_cache(0), head(0), tail_cache(0)
+    {
+      size_type cap = 2;
+      while (cap < n) cap <<= 1;
+      buf = data_allocator::allocate(cap);
+      mask = cap - 1;
+    }
+    ~spsc_queue()
+    {
+      size_type h = head.load(std::memory_order_relaxed);
+      const size_type t = tail.load(std::memory_order_relaxed);
+      for ( ; h != t; ++h)
+        tinystl::destroy(buf + (h & mask));
+      data_allocator::deallocate(buf, capacity_());
+    }
+
+    size_type capacity() const { return capacity_(); }
+    // 另一端同时在操作时，size() / empty() 只是某一瞬间的近似值
+    size_type size() const
+    {
+      const size_type h = head.load(std::memory_order_acquire);
+      return tail.load(std::memory_order_acquire) - h;
+    }
+    bool empty() const { return size() == 0; }
+
+    // 生产者
+    // 已满时传回 false
+    bool push(const value_type& x)
+    {
+      const size_type t = tail.load(std::memory_order_relaxed);
+      if (free_slots(t, 1) == 0)
+        return false;
+      construct(buf + (t & mask), x);
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+    // 写入 first 起至多 n 个元素，传回实际写入的个数
+    // 只发布一次 tail，最多分成两段整块复制
+    template <class ForwardIterator>
+      size_type push_n(ForwardIterator first, size_type n);
+
+    // 消费者
+    // 队列不可为空；消费者看到 !empty() 后，元素不会被生产者取走
+    reference front() { return buf[head.load(std::memory_order_relaxed) & mask]; }
+    void pop()
+    {
+      const size_type h = head.load(std::memory_order_relaxed);
+      tinystl::destroy(buf + (h & mask));
+      // 队列非空，tail 至少为 h + 1；维持 tail_cache 不小于 head
+      if (tail_cache == h) tail_cache = h + 1;
+      head.store(h + 1, std::memory_order_release);
+    }
+    // 为空时传回 false
+    bool try_pop(value_type& x)
+    {
+      const size_type h = head.load(std::memory_order_relaxed);
+      if (ready_slots(h, 1) == 0)
+        return false;
+      T* p = buf + (h & mask);
+      x = *p;
+      tinystl::destroy(p);
+      head.store(h + 1, std::memory_order_release);
+      return true;
+    }
+    // 取出至多 n 个元素写至 result，传回实际取出的个数
+    template <class OutputIterator>
+      size_type pop_n(OutputIterator result, size_type n);
+  };
+
+template <class T, class Alloc>
+  template <class ForwardIterator>
+  typename spsc_queue<T, Alloc>::size_type
+  spsc_queue<T, Alloc>::push_n(ForwardIterator first, size_type n)
+  {
+    const size_type t = tail.load(std::memory_order_relaxed);
+    n = tinystl::min(n, free_slots(t, n));
+    if (n == 0) return 0;
+    const size_type i = t & mask;
+    const size_type len = tinystl::min(n, capacity_() - i); // 第一段至缓冲区尾端
+    ForwardIterator mid = first;
+    tinystl::advance(mid, len);
+    tinystl::uninitialized_copy(first, mid, buf + i);
+    if (len < n) {
+      ForwardIterator last = mid;
+      tinystl::advance(last, n - len);
+      try {
+        tinystl::uninitialized_copy(mid, last, buf);
+      } catch(...) {
+        tinystl::destroy(buf + i, buf + i + len);
+        throw;
+      }
+    }
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+template <class T, class Alloc>
+  template <class OutputIterator>
+  typename spsc_queue<T, Alloc>::size_type
+  spsc_queue<T, Alloc>::pop_n(OutputIterator result, size_type n)
+  {
+    const size_type h = head.load(std::memory_order_relaxed);
+    n = tinystl::min(n, ready_slots(h, n));
+    if (n == 0) return 0;
+    const size_type i = h & mask;
+    const size_type len = tinystl::min(n, capacity_() - i);
+    result = tinystl::copy(buf + i, buf + i + len, result);
+    tinystl::copy(buf, buf + (n - len), result);
+    tinystl::destroy(buf + i, buf + i + len);
+    tinystl::destroy(buf, buf + (n - len));
+    head.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_SPSC_QUEUE_H_
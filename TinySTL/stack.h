@@ -13,7 +13,13 @@
 namespace tinystl
 {
 
-template <class T, class Sequence = deque<T> >
+template <class T, class Sequence = deque<T> > class stack;
+template <class T, class Sequence>
+  bool operator==(const stack<T, Sequence>& x, const stack<T, Sequence>& y);
+template <class T, class Sequence>
+  bool operator<(const stack<T, Sequence>& x, const stack<T, Sequence>& y);
+
+template <class T, class Sequence>
   class stack
   {
     friend bool operator==<>(const stack&, const stack&);
@@ -26,6 +32,9 @@ template <class T, class Sequence = deque<T> >
     protected:
     Sequence c; // 底层容器
     public:
+    stack() : c() { }
+    // 以既有的容器构造，例如指定容量的 circular_buffer
+    explicit stack(const Sequence& s) : c(s) { }
     // 完全利用 Sequence c 的操作，完成 stack 的操作
     bool empty() const { return c.empty(); }
     size_type size() const { return c.size(); }
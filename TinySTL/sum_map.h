@@ -0,0 +1,191 @@
+
+/**
+ * sum_map
+ * 可查询区间总和的 map：以 rb_subtree_sum 增强的 rb_tree，每个节点记录子树中 mapped 值的总和。
+ *   prefix_sum(k)        键值小于 k 的元素的总和，O(log n)
+ *   range_sum(lo, hi)    键值位于 [lo, hi) 的元素的总和，O(log n)
+ *   total_sum()          全部元素的总和，O(1)
+ * T 需提供 T() 作为零与满足交换律、结合律的 operator+=，计算过程不使用减法。
+ *
+ * 修改 mapped 值必须经由 assign() 或 add()，以便重新计算总和；
+ * 迭代器与 set 一样为唯读，iterator 与 const_iterator 相同。
+ */
+#ifndef TINYSTL_SUM_MAP_H_
+#define TINYSTL_SUM_MAP_H_
+
+#include "alloc.h"
+#include "pair.h"
+#include "function.h"
+#include "tree.h"
+
+namespace tinystl
+{
+
+// rb_tree 的增强：子树中各元素经 Weight 取出的值的总和
+template <class T, class Weight>
+  struct rb_subtree_sum
+  {
+    typedef T meta_type;
+
+    template <class Value>
+      static void update(meta_type& m, const Value& v, const meta_type* left, const meta_type* right)
+      {
+        m = Weight()(v);
+        if (left) m += *left;
+        if (right) m += *right;
+      }
+  };
+
+template <class Key, class T, class Compare = less<Key>, class Alloc = alloc>
+  class sum_map
+  {
+    public:
+    typedef Key                    key_type;
+    typedef T                      data_type;
+    typedef T                      mapped_type;
+    typedef pair<const Key, T>     value_type;
+    typedef Compare                key_compare;
+
+    private:
+    typedef rb_tree<key_type, value_type, select1st<value_type>, key_compare, Alloc,
+                    rb_subtree_sum<T, select2nd<value_type> > > rep_type;
+    typedef typename rep_type::link_type          link_type;
+    typedef typename rep_type::iterator           rep_iterator;
+    rep_type t;
+
+    public:
+    typedef typename rep_type::const_iterator     iterator;
+    typedef typename rep_type::const_iterator     const_iterator;
+    typedef typename rep_type::const_reference    reference;
+    typedef typename rep_type::const_reference    const_reference;
+    typedef typename rep_type::size_type          size_type;
+    typedef typename rep_type::difference_type    difference_type;
+
+    private:
+    static const Key& key(link_type x) { return x->value_field.first; }
+    static rep_iterator to_rep(iterator i) { return rep_iterator((link_type)i.node); }
+    // 子树总和加到 result
+    static void add_subtree(T& result, __rb_tree_node_base* x)
+    {
+      if (x) result += ((link_type)x)->meta;
+    }
+
+    public:
+    // 构造
+    sum_map() : t(Compare()) { }
+    explicit sum_map(const Compare& comp) : t(comp) { }
+    template <class InputIterator>
+      sum_map(InputIterator first, InputIterator last) : t(Compare())
+      { t.insert_unique(first, last); }
+
+    // 存取
+    key_compare key_comp() const { return t.key_comp(); }
+    iterator begin() const { return t.begin(); }
+    iterator end() const { return t.end(); }
+    bool empty() const { return t.empty(); }
+    size_type size() const { return t.size(); }
+    size_type max_size() const { return t.max_size(); }
+    void swap(sum_map& x) { t.swap(x.t); }
+
+    // 插入、删除
+    pair<iterator, bool> insert(const value_type& x)
+    {
+      pair<rep_iterator, bool> p = t.insert_unique(x);
+      return pair<iterator, bool>(p.first, p.second);
+    }
+    iterator insert(iterator position, const value_type& x) { return t.insert_unique(to_rep(position), x); }
+    template <class InputIterator>
+      void insert(InputIterator first, InputIterator last) { t.insert_unique(first, last); }
+    // 以已排序、键值不重复的 [first, last) 取代原有内容，O(n)
+    template <class ForwardIterator>
+      void assign_sorted(ForwardIterator first, ForwardIterator last) { t.assign_sorted(first, last); }
+    // 将 k 的值设为 x，不存在时插入
+    iterator assign(const key_type& k, const T& x)
+    {
+      pair<rep_iterator, bool> p = t.insert_unique(value_type(k, x));
+      if (!p.second) {
+        p.first->second = x;
+        t.__update(p.first);
+      }
+      return p.first;
+    }
+    // 将 k 的值加上 delta，不存在时以 T() 为初值插入
+    iterator add(const key_type& k, const T& delta)
+    {
+      rep_iterator i = t.insert_unique(value_type(k, T())).first;
+      i->second += delta;
+      t.__update(i);
+      return i;
+    }
+    void erase(iterator position) { t.erase(to_rep(position)); }
+    size_type erase(const key_type& x) { return t.erase(x); }
+    void erase(iterator first, iterator last) { t.erase(to_rep(first), to_rep(last)); }
+    void clear() { t.clear(); }
+
+    // 搜寻
+    iterator find(const key_type& x) const { return t.find(x); }
+    size_type count(const key_type& x) const { return t.count(x); }
+    iterator lower_bound(const key_type& x) const { return t.lower_bound(x); }
+    iterator upper_bound(const key_type& x) const { return t.upper_bound(x); }
+    pair<iterator, iterator> equal_range(const key_type& x) const { return t.equal_range(x); }
+
+    // 区间总和
+    T total_sum() const
+    {
+      T result = T();
+      add_subtree(result, t.__root());
+      return result;
+    }
+    T prefix_sum(const key_type& k) const;
+    T range_sum(const key_type& lo, const key_type& hi) const;
+  };
+
+template <class Key, class T, class Compare, class Alloc>
+  T sum_map<Key, T, Compare, Alloc>::prefix_sum(const key_type& k) const
+  {
+    const key_compare comp = key_comp();
+    T result = T();
+    link_type x = t.__root();
+    while (x != 0)
+      if (comp(key(x), k)) { // x 与其左子树都小于 k
+        add_subtree(result, x->left);
+        result += x->value_field.second;
+        x = (link_type)x->right;
+      } else
+        x = (link_type)x->left;
+    return result;
+  }
+
+template <class Key, class T, class Compare, class Alloc>
+  T sum_map<Key, T, Compare, Alloc>::range_sum(const key_type& lo, const key_type& hi) const
+  {
+    const key_compare comp = key_comp();
+    T result = T();
+    // 找出第一个落在 [lo, hi) 的节点(分岔点)，区间内的其他节点都在它的子树中
+    link_type x = t.__root();
+    while (x != 0 && (comp(key(x), lo) || !comp(key(x), hi)))
+      x = (link_type)(comp(key(x), lo) ? x->right : x->left);
+    if (x == 0) return result;
+    result += x->value_field.second;
+    // 左子树中不小于 lo 的部分
+    for (link_type y = (link_type)x->left; y != 0; )
+      if (!comp(key(y), lo)) { // y 与其右子树都在区间内
+        add_subtree(result, y->right);
+        result += y->value_field.second;
+        y = (link_type)y->left;
+      } else
+        y = (link_type)y->right;
+    // 右子树中小于 hi 的部分
+    for (link_type y = (link_type)x->right; y != 0; )
+      if (comp(key(y), hi)) { // y 与其左子树都在区间内
+        add_subtree(result, y->left);
+        result += y->value_field.second;
+        y = (link_type)y->right;
+      } else
+        y = (link_type)y->left;
+    return result;
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_SUM_MAP_H_
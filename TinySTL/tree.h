@@ -5,7 +5,10 @@
 #include "iterator.h"
 #include "algobase.h"
 #include "function.h"
+#include "pair.h"
 #include "construct.h"
+#include "type_traits.h"
+#include "node_arena.h"
 
 namespace tinystl
 {
@@ -97,7 +100,7 @@ template <class Value, class Ref, class Ptr>
     typedef __rb_tree_iterator<Value, Value&, Value*>                 iterator;
     typedef __rb_tree_iterator<Value, const Value&, const Value*>     const_iterator;
     typedef __rb_tree_iterator<Value, Ref, Ptr>                       self;
-    typedef __rb_tree_iterator<Value>*                                link_type;
+    typedef __rb_tree_node<Value>*                                    link_type;
 
     __rb_tree_iterator() { }
     __rb_tree_iterator(link_type x) { node = x; }
@@ -119,15 +122,323 @@ template <class Value, class Ref, class Ptr>
     }
   };
 
+inline bool operator==(const __rb_tree_base_iterator& x, const __rb_tree_base_iterator& y)
+{ return x.node == y.node; }
+inline bool operator!=(const __rb_tree_base_iterator& x, const __rb_tree_base_iterator& y)
+{ return x.node != y.node; }
+
+
+/**
+ * 增强(augmentation)：每个节点附加一份由子树计算而得的资料(例如子树大小、子树总和)，
+ * 以 rb_tree 的最后一个模板参数 Augment 指定。Augment 须提供：
+ *   typedef ... meta_type;
+ *   template <class Value>
+ *     static void update(meta_type& m, const Value& v, const meta_type* left, const meta_type* right);
+ *       以节点本身的值与左右子节点的资料(没有子节点时为 0)重新计算 m
+ * meta_type 紧接在节点的值之后，插入、删除与旋转时由下而上重新计算，维护的代价为 O(log n)。
+ * 缺省的 rb_no_augment 不附加任何资料，节点与原本相同。
+ */
+struct rb_no_augment { };
+
+template <class Value, class Augment>
+  struct __rb_tree_aug_node : public __rb_tree_node<Value>
+  {
+    typedef typename Augment::meta_type meta_type;
+    meta_type meta;
+  };
+
+template <class T1, class T2>
+  struct __rb_tree_both_trivial { typedef __false_type type; };
+template <>
+  struct __rb_tree_both_trivial<__true_type, __true_type> { typedef __true_type type; };
+
+// rb_tree 与全局平衡函数透过这里存取附加资料
+template <class Value, class Augment>
+  struct __rb_tree_augment_traits
+  {
+    enum { augmented = true };
+    typedef __rb_tree_aug_node<Value, Augment>      node_type;
+    typedef typename Augment::meta_type             meta_type;
+    typedef typename __rb_tree_both_trivial<
+      typename __type_traits<Value>::has_trivial_destructor,
+      typename __type_traits<meta_type>::has_trivial_destructor>::type trivial_destructor;
+
+    static void update(__rb_tree_node_base* x)
+    {
+      node_type* p = (node_type*)x;
+      node_type* l = (node_type*)x->left;
+      node_type* r = (node_type*)x->right;
+      Augment::update(p->meta, p->value_field, l ? &l->meta : 0, r ? &r->meta : 0);
+    }
+    static void construct(node_type* p) { tinystl::construct(&p->meta, meta_type()); }
+    static void destroy(node_type* p) { tinystl::destroy(&p->meta); }
+    static void copy(node_type* to, const node_type* from) { to->meta = from->meta; }
+  };
+template <class Value>
+  struct __rb_tree_augment_traits<Value, rb_no_augment>
+  {
+    enum { augmented = false };
+    typedef __rb_tree_node<Value>     node_type;
+    typedef typename __type_traits<Value>::has_trivial_destructor trivial_destructor;
+
+    static void update(__rb_tree_node_base*) { }
+    static void construct(node_type*) { }
+    static void destroy(node_type*) { }
+    static void copy(node_type*, const node_type*) { }
+  };
+
+// 由 x 往上至根，依序重新计算附加资料；x 为 0 或 header 时不做事
+template <class AugTraits>
+  inline void __rb_tree_update_path(__rb_tree_node_base* x, __rb_tree_node_base* root)
+  {
+    if (!AugTraits::augmented || root == 0) return;
+    for (__rb_tree_node_base* end = root->parent; x != 0 && x != end; x = x->parent)
+      AugTraits::update(x);
+  }
+
+
+/**
+ * 全局函数：旋转与平衡
+ * AugTraits 为 __rb_tree_augment_traits，旋转后重新计算位置改变的两个节点的附加资料；
+ * 旋转不改变子树的元素，更上层的资料不受影响
+ */
+// 左旋，x 为旋转点
+template <class AugTraits>
+  inline void __rb_tree_rotate_left(__rb_tree_node_base* x, __rb_tree_node_base*& root)
+  {
+    __rb_tree_node_base* y = x->right; // y 为旋转点的右子节点
+    x->right = y->left;
+    if (y->left != 0)
+      y->left->parent = x;
+    y->parent = x->parent;
+    // 令 y 完全顶替 x 的地位
+    if (x == root)
+      root = y;
+    else if (x == x->parent->left)
+      x->parent->left = y;
+    else
+      x->parent->right = y;
+    y->left = x;
+    x->parent = y;
+    AugTraits::update(x);
+    AugTraits::update(y);
+  }
+// 右旋，x 为旋转点
+template <class AugTraits>
+  inline void __rb_tree_rotate_right(__rb_tree_node_base* x, __rb_tree_node_base*& root)
+  {
+    __rb_tree_node_base* y = x->left; // y 为旋转点的左子节点
+    x->left = y->right;
+    if (y->right != 0)
+      y->right->parent = x;
+    y->parent = x->parent;
+    if (x == root)
+      root = y;
+    else if (x == x->parent->right)
+      x->parent->right = y;
+    else
+      x->parent->left = y;
+    y->right = x;
+    x->parent = y;
+    AugTraits::update(x);
+    AugTraits::update(y);
+  }
+
+// 新节点 x 插入后重新平衡：改变颜色并旋转
+// 调用前 x 到根的附加资料必须已经更新
+template <class AugTraits>
+  inline void __rb_tree_rebalance(__rb_tree_node_base* x, __rb_tree_node_base*& root)
+  {
+    x->color = __rb_tree_red; // 新节点必为红
+    while (x != root && x->parent->color == __rb_tree_red) { // 父节点为红
+      if (x->parent == x->parent->parent->left) { // 父节点为祖父节点的左子节点
+        __rb_tree_node_base* y = x->parent->parent->right; // y 为伯父节点
+        if (y && y->color == __rb_tree_red) { // 伯父节点为红：改变颜色，继续往上检查
+          x->parent->color = __rb_tree_black;
+          y->color = __rb_tree_black;
+          x->parent->parent->color = __rb_tree_red;
+          x = x->parent->parent;
+        } else { // 无伯父节点或伯父节点为黑：旋转
+          if (x == x->parent->right) {
+            x = x->parent;
+            __rb_tree_rotate_left<AugTraits>(x, root);
+          }
+          x->parent->color = __rb_tree_black;
+          x->parent->parent->color = __rb_tree_red;
+          __rb_tree_rotate_right<AugTraits>(x->parent->parent, root);
+        }
+      } else { // 父节点为祖父节点的右子节点，与上面对称
+        __rb_tree_node_base* y = x->parent->parent->left;
+        if (y && y->color == __rb_tree_red) {
+          x->parent->color = __rb_tree_black;
+          y->color = __rb_tree_black;
+          x->parent->parent->color = __rb_tree_red;
+          x = x->parent->parent;
+        } else {
+          if (x == x->parent->left) {
+            x = x->parent;
+            __rb_tree_rotate_right<AugTraits>(x, root);
+          }
+          x->parent->color = __rb_tree_black;
+          x->parent->parent->color = __rb_tree_red;
+          __rb_tree_rotate_left<AugTraits>(x->parent->parent, root);
+        }
+      }
+    }
+    root->color = __rb_tree_black; // 根节点永远为黑
+  }
+
+// 将 z 自树中摘除并重新平衡，传回实际摘除的节点(即 z，由调用端释还)
+template <class AugTraits>
+  inline __rb_tree_node_base*
+  __rb_tree_rebalance_for_erase(__rb_tree_node_base* z,
+                                __rb_tree_node_base*& root,
+                                __rb_tree_node_base*& leftmost,
+                                __rb_tree_node_base*& rightmost)
+  {
+    __rb_tree_node_base* y = z;
+    __rb_tree_node_base* x = 0;
+    __rb_tree_node_base* x_parent = 0;
+    if (y->left == 0)             // z 最多只有一个子节点，y == z
+      x = y->right;               // x 可能为 0
+    else if (y->right == 0)       // z 只有一个子节点，y == z
+      x = y->left;
+    else {                        // z 有两个子节点，y 为 z 的后继节点
+      y = y->right;
+      while (y->left != 0)
+        y = y->left;
+      x = y->right;
+    }
+    if (y != z) { // 以 y 取代 z 的位置(改变串接而非复制元素，指向其他元素的迭代器仍然有效)
+      z->left->parent = y;
+      y->left = z->left;
+      if (y != z->right) {
+        x_parent = y->parent;
+        if (x) x->parent = y->parent;
+        y->parent->left = x; // y 必为左子节点
+        y->right = z->right;
+        z->right->parent = y;
+      } else
+        x_parent = y;
+      if (root == z)
+        root = y;
+      else if (z->parent->left == z)
+        z->parent->left = y;
+      else
+        z->parent->right = y;
+      y->parent = z->parent;
+      __rb_tree_color_type tmp = y->color;
+      y->color = z->color;
+      z->color = tmp;
+      y = z; // y 指向实际要删除的节点
+    } else { // y == z
+      x_parent = y->parent;
+      if (x) x->parent = y->parent;
+      if (root == z)
+        root = x;
+      else if (z->parent->left == z)
+        z->parent->left = x;
+      else
+        z->parent->right = x;
+      if (leftmost == z) {
+        if (z->right == 0) // z->left 必为 0
+          leftmost = z->parent; // z == root 时 leftmost 成为 header
+        else
+          leftmost = __rb_tree_node_base::minimum(x);
+      }
+      if (rightmost == z) {
+        if (z->left == 0) // z->right 必为 0
+          rightmost = z->parent;
+        else
+          rightmost = __rb_tree_node_base::maximum(x);
+      }
+    }
+    // 结构改变处(x_parent)以上的附加资料先更新，之后的旋转只需局部重新计算
+    __rb_tree_update_path<AugTraits>(x_parent, root);
+    // 删除的是黑节点：x 这一侧少了一个黑节点，往上调整
+    if (y->color != __rb_tree_red) {
+      while (x != root && (x == 0 || x->color == __rb_tree_black))
+        if (x == x_parent->left) {
+          __rb_tree_node_base* w = x_parent->right; // 兄弟节点
+          if (w->color == __rb_tree_red) {
+            w->color = __rb_tree_black;
+            x_parent->color = __rb_tree_red;
+            __rb_tree_rotate_left<AugTraits>(x_parent, root);
+            w = x_parent->right;
+          }
+          if ((w->left == 0 || w->left->color == __rb_tree_black) &&
+              (w->right == 0 || w->right->color == __rb_tree_black)) {
+            w->color = __rb_tree_red;
+            x = x_parent;
+            x_parent = x_parent->parent;
+          } else {
+            if (w->right == 0 || w->right->color == __rb_tree_black) {
+              if (w->left) w->left->color = __rb_tree_black;
+              w->color = __rb_tree_red;
+              __rb_tree_rotate_right<AugTraits>(w, root);
+              w = x_parent->right;
+            }
+            w->color = x_parent->color;
+            x_parent->color = __rb_tree_black;
+            if (w->right) w->right->color = __rb_tree_black;
+            __rb_tree_rotate_left<AugTraits>(x_parent, root);
+            break;
+          }
+        } else { // 与上面对称
+          __rb_tree_node_base* w = x_parent->left;
+          if (w->color == __rb_tree_red) {
+            w->color = __rb_tree_black;
+            x_parent->color = __rb_tree_red;
+            __rb_tree_rotate_right<AugTraits>(x_parent, root);
+            w = x_parent->left;
+          }
+          if ((w->right == 0 || w->right->color == __rb_tree_black) &&
+              (w->left == 0 || w->left->color == __rb_tree_black)) {
+            w->color = __rb_tree_red;
+            x = x_parent;
+            x_parent = x_parent->parent;
+          } else {
+            if (w->left == 0 || w->left->color == __rb_tree_black) {
+              if (w->right) w->right->color = __rb_tree_black;
+              w->color = __rb_tree_red;
+              __rb_tree_rotate_left<AugTraits>(w, root);
+              w = x_parent->left;
+            }
+            w->color = x_parent->color;
+            x_parent->color = __rb_tree_black;
+            if (w->left) w->left->color = __rb_tree_black;
+            __rb_tree_rotate_right<AugTraits>(x_parent, root);
+            break;
+          }
+        }
+      if (x) x->color = __rb_tree_black;
+    }
+    return y;
+  }
+
+// 由 x 往上到 root 的黑节点数
+inline int __black_count(__rb_tree_node_base* x, __rb_tree_node_base* root)
+{
+  if (x == 0) return 0;
+  int bc = x->color == __rb_tree_black ? 1 : 0;
+  return x == root ? bc : bc + __black_count(x->parent, root);
+}
+
+
 // RB-tree
-template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc>
-  class rb_tree
+// Alloc 为 node_arena<> 时，节点来自 rb_tree 自己的节点区，见 node_arena.h
+// Augment 为每个节点附加的资料，见上方 rb_no_augment 的说明
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc = alloc,
+          class Augment = rb_no_augment>
+  class rb_tree : protected __node_storage<
+                    typename __rb_tree_augment_traits<Value, Augment>::node_type, Alloc>
   {
     protected:
-    typedef void*                                 void_pointer;
-    typedef __rb_tree_node_base*                  base_ptr;
-    typedef __rb_tree_node<Value>                 rb_tree_node;
-    typedef simple_alloc<rb_tree_node, Alloc>     rb_tree_node_allocator;
+    typedef void*                                         void_pointer;
+    typedef __rb_tree_node_base*                          base_ptr;
+    typedef __rb_tree_augment_traits<Value, Augment>      aug_traits;
+    typedef typename aug_traits::node_type                rb_tree_node;
+    typedef __node_storage<rb_tree_node, Alloc>           node_storage;
     typedef __rb_tree_color_type                  color_type;
     public:
     typedef Key                   key_type;
@@ -140,8 +451,8 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
     typedef size_t                size_type;
     typedef ptrdiff_t             difference_type;
     protected:
-    link_type get_node() { return rb_tree_node_allocator::allocate(); }
-    void put_node(link_type p) { rb_tree_node_allocator::deallocate(p); }
+    link_type get_node() { return this->allocate_node(); }
+    void put_node(link_type p) { this->deallocate_node(p); }
 
     link_type create_node(const value_type& x)
     {
@@ -150,14 +461,23 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
         construct(&tmp->value_field, x);
       } catch(...) {
         put_node(tmp);
+        throw;
+      }
+      try {
+        aug_traits::construct(tmp);
+      } catch(...) {
+        destroy(&tmp->value_field);
+        put_node(tmp);
+        throw;
       }
       return tmp;
     }
 
     link_type clone_node(link_type x)
     { // 复制节点值和色
-      link_type tmp = creat_node(x->value_field);
+      link_type tmp = create_node(x->value_field);
       tmp->color = x->color;
+      aug_traits::copy(tmp, x);
       tmp->left = 0;
       tmp->right = 0;
       return tmp;
@@ -165,7 +485,8 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
 
     void destroy_node(link_type p)
     {
-      distroy(&p->value_field);
+      aug_traits::destroy(p);
+      destroy(&p->value_field);
       put_node(p);
     }
 
@@ -197,7 +518,7 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
     static link_type& left(base_ptr x) { return (link_type&)x->left; }
     static link_type& right(base_ptr x) { return (link_type&)x->right; }
     static link_type& parent(base_ptr x) { return (link_type&)x->parent; }
-    static const Key& key(link_type x) { return KeyOfValue()(valuel(link_type(x))); }
+    static const Key& key(base_ptr x) { return KeyOfValue()(value(link_type(x))); }
     static color_type& color(base_ptr x) { return (color_type&)(link_type(x)->color); }
     static reference value(base_ptr x) { return (link_type(x))->value_field; }
 
@@ -206,15 +527,21 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
     static link_type maximum(link_type x) { return (link_type)__rb_tree_node_base::maximum(x); }
 
     public:
-    typedef __rb_tree_iterator<value_type, reference, pointer>     iterator;
+    typedef __rb_tree_iterator<value_type, reference, pointer>                 iterator;
+    typedef __rb_tree_iterator<value_type, const_reference, const_pointer>     const_iterator;
 
     private:
     iterator __insert(base_ptr x, base_ptr y, const value_type& v);
     link_type __copy(link_type x, link_type p);
     void __erase(link_type x);
+    // 解构以 x 为根的子树中的元素，不释还节点
+    void __destroy_values(link_type x, __false_type);
+    void __destroy_values(link_type, __true_type) { }
+    // 将串在 right 上的 n 个已排序节点组成平衡的子树，第 red_depth 层为红，其余为黑
+    static link_type __link_sorted(link_type& chain, size_type n, size_type depth, size_type red_depth);
     void init()
     {
-      header = get_node();
+      header = this->allocate_header();
       color(header) = __rb_tree_red; // header 为红，与root 区分
       root() = 0;
       leftmost() = header;
@@ -223,31 +550,518 @@ template <class Key, class Value, class KeyOfValue, class Compare, class Alloc =
 
     public:
     rb_tree(const Compare& comp = Compare())
-    : node_count(0), key_compare(comp) { init();; }
+    : node_count(0), key_compare(comp) { init(); }
+    rb_tree(const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>& x)
+    : node_count(0), key_compare(x.key_compare)
+    {
+      init();
+      if (x.root() != 0) {
+        try {
+          root() = __copy(x.root(), header);
+        } catch(...) {
+          this->deallocate_header(header);
+          throw;
+        }
+        leftmost() = minimum(root());
+        rightmost() = maximum(root());
+        node_count = x.node_count;
+      }
+    }
     ~rb_tree()
     {
       clear();
-      put_node(header);
+      this->deallocate_header(header);
     }
 
-    rb_tree<Key, Value, keyOfValue, Compare, Alloc>& operator=
-    (const rb_tree<Key, Value, KeyOfValue, Compare, Alloc>& x);
+    rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>& operator=
+    (const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>& x);
 
     Compare key_comp() const { return key_compare; }
     iterator begin() { return leftmost(); }
+    const_iterator begin() const { return leftmost(); }
     iterator end() { return header; }
+    const_iterator end() const { return header; }
     bool empty() const { return node_count == 0; }
     size_type size() const { return node_count; }
     size_type max_size() const { return size_type(-1); }
+    void swap(rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>& t)
+    {
+      link_type tmp = header;
+      header = t.header;
+      t.header = tmp;
+      size_type n = node_count;
+      node_count = t.node_count;
+      t.node_count = n;
+      Compare c = key_compare;
+      key_compare = t.key_compare;
+      t.key_compare = c;
+      this->swap_nodes(t);
+    }
 
     // 将x 插入RB-tree，保持节点值独一无二
     pair<iterator, bool> insert_unique(const value_type& x);
     // 将x 插入RB-tree，允许节点重复
     iterator insert_equal(const value_type& x);
+    // position 为插入位置的提示：x 应紧接在 position 之前。
+    // 提示正确时不需由根往下搜寻，连同重新平衡为均摊 O(1)；依序插入已排序的数据时以 end() 为提示
+    // 提示不正确时与不带提示的版本相同
+    iterator insert_unique(iterator position, const value_type& x);
+    iterator insert_equal(iterator position, const value_type& x);
+    // 区间插入，每个元素以 end() 为提示，已排序的数据为 O(n)
+    template <class InputIterator>
+      void insert_unique(InputIterator first, InputIterator last)
+      {
+        for ( ; first != last; ++first)
+          insert_unique(end(), *first);
+      }
+    template <class InputIterator>
+      void insert_equal(InputIterator first, InputIterator last)
+      {
+        for ( ; first != last; ++first)
+          insert_equal(end(), *first);
+      }
+    // 以已排序的 [first, last) 取代原有内容：直接建成平衡且已着色的树，不做任何旋转，O(n)
+    // [first, last) 必须依 key_comp() 递增；用于 insert_unique 的树时键值不可重复
+    // 复制元素抛出异常时树成为空的
+    template <class ForwardIterator>
+      void assign_sorted(ForwardIterator first, ForwardIterator last);
+
+    void erase(iterator position)
+    {
+      link_type y = (link_type)__rb_tree_rebalance_for_erase<aug_traits>(position.node, header->parent,
+                                                                        header->left, header->right);
+      destroy_node(y);
+      --node_count;
+    }
+    size_type erase(const key_type& x);
+    void erase(iterator first, iterator last);
+
+    // 使用 node_arena 时一次将节点全部归还节点区，元素有 trivial destructor 时为 O(chunks)
+    void clear()
+    {
+      if (node_count != 0) {
+        if (node_storage::arena) {
+          typedef typename aug_traits::trivial_destructor trivial_destructor;
+          __destroy_values(root(), trivial_destructor());
+          this->release_nodes();
+        } else
+          __erase(root());
+        leftmost() = header;
+        root() = 0;
+        rightmost() = header;
+        node_count = 0;
+      }
+    }
+
+    // 搜寻
+    iterator find(const key_type& k);
+    const_iterator find(const key_type& k) const;
+    size_type count(const key_type& k) const;
+    // 第一个不小于 k 的元素
+    iterator lower_bound(const key_type& k);
+    const_iterator lower_bound(const key_type& k) const;
+    // 第一个大于 k 的元素
+    iterator upper_bound(const key_type& k);
+    const_iterator upper_bound(const key_type& k) const;
+    pair<iterator, iterator> equal_range(const key_type& k)
+    { return pair<iterator, iterator>(lower_bound(k), upper_bound(k)); }
+    pair<const_iterator, const_iterator> equal_range(const key_type& k) const
+    { return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k)); }
+
+    // 检查红黑树的性质与 header 的记录，供除错使用
+    bool __rb_verify() const;
+
+    // 供依附加资料查询的容器(order_statistic_set 等)由根往下走访，空树时为 0
+    link_type __root() const { return root(); }
+    // 修改 position 所指元素中附加资料依赖的部分后调用，重新计算到根为止的资料，O(log n)
+    void __update(iterator position)
+    {
+      if (position.node != header)
+        __rb_tree_update_path<aug_traits>(position.node, header->parent);
+    }
   };
 
-} // namespace tinystl
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>&
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::operator=
+  (const rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>& x)
+  {
+    if (this != &x) {
+      rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment> tmp(x);
+      swap(tmp);
+    }
+    return *this;
+  }
 
-#endif // !TINYSTL_TREE_H_
+// x 为新值插入点，y 为插入点的父节点，v 为新值
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__insert(base_ptr x_, base_ptr y_, const value_type& v)
+  {
+    link_type x = (link_type)x_;
+    link_type y = (link_type)y_;
+    link_type z = create_node(v);
+    if (y == header || x != 0 || key_compare(KeyOfValue()(v), key(y))) {
+      left(y) = z; // y 为 header 时，leftmost() = z
+      if (y == header) {
+        root() = z;
+        rightmost() = z;
+      } else if (y == leftmost())
+        leftmost() = z;
+    } else {
+      right(y) = z;
+      if (y == rightmost())
+        rightmost() = z;
+    }
+    parent(z) = y;
+    left(z) = 0;
+    right(z) = 0;
+    __rb_tree_update_path<aug_traits>(z, header->parent);
+    __rb_tree_rebalance<aug_traits>(z, header->parent);
+    ++node_count;
+    return iterator(z);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::insert_equal(const value_type& v)
+  {
+    link_type y = header;
+    link_type x = root();
+    while (x != 0) { // 由根往下，遇大往左，遇小或等于往右
+      y = x;
+      x = key_compare(KeyOfValue()(v), key(x)) ? left(x) : right(x);
+    }
+    return __insert(x, y, v);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  pair<typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator, bool>
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::insert_unique(const value_type& v)
+  {
+    link_type y = header;
+    link_type x = root();
+    bool comp = true;
+    while (x != 0) {
+      y = x;
+      comp = key_compare(KeyOfValue()(v), key(x));
+      x = comp ? left(x) : right(x);
+    }
+    // y 为插入点的父节点
+    iterator j = iterator(y);
+    if (comp) { // 插入于左侧
+      if (j == begin())
+        return pair<iterator, bool>(__insert(x, y, v), true);
+      else
+        --j;
+    }
+    if (key_compare(key(j.node), KeyOfValue()(v))) // 新键值不与既有节点重复
+      return pair<iterator, bool>(__insert(x, y, v), true);
+    return pair<iterator, bool>(j, false);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::insert_unique(iterator position, const value_type& v)
+  {
+    if (position.node == header->left) { // begin()
+      if (size() > 0 && key_compare(KeyOfValue()(v), key(position.node)))
+        return __insert(position.node, position.node, v); // 第一个参数不为 0，插入于左侧
+      return insert_unique(v).first;
+    } else if (position.node == header) { // end()
+      if (key_compare(key(rightmost()), KeyOfValue()(v)))
+        return __insert(0, rightmost(), v);
+      return insert_unique(v).first;
+    } else {
+      iterator before = position;
+      --before;
+      if (key_compare(key(before.node), KeyOfValue()(v)) &&
+          key_compare(KeyOfValue()(v), key(position.node))) {
+        // before 与 position 相邻，两者之一必有空着的子节点位置
+        if (right(before.node) == 0)
+          return __insert(0, before.node, v);
+        return __insert(position.node, position.node, v);
+      }
+      return insert_unique(v).first;
+    }
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::insert_equal(iterator position, const value_type& v)
+  {
+    if (position.node == header->left) { // begin()
+      if (size() > 0 && !key_compare(key(position.node), KeyOfValue()(v)))
+        return __insert(position.node, position.node, v);
+      return insert_equal(v);
+    } else if (position.node == header) { // end()
+      if (!key_compare(KeyOfValue()(v), key(rightmost())))
+        return __insert(0, rightmost(), v);
+      return insert_equal(v);
+    } else {
+      iterator before = position;
+      --before;
+      if (!key_compare(KeyOfValue()(v), key(before.node)) &&
+          !key_compare(key(position.node), KeyOfValue()(v))) {
+        if (right(before.node) == 0)
+          return __insert(0, before.node, v);
+        return __insert(position.node, position.node, v);
+      }
+      return insert_equal(v);
+    }
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  template <class ForwardIterator>
+  void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::assign_sorted(ForwardIterator first, ForwardIterator last)
+  {
+    clear();
+    if (first == last) return;
+    // 先依序配置所有节点，以 right 串成一条链；失败时释还已配置的节点，树维持为空
+    link_type chain = 0;
+    link_type tail = 0;
+    size_type n = 0;
+    try {
+      for ( ; first != last; ++first, ++n) {
+        link_type z = create_node(*first);
+        right(z) = 0;
+        if (tail) right(tail) = z;
+        else chain = z;
+        tail = z;
+      }
+    } catch(...) {
+      while (chain) {
+        link_type next = right(chain);
+        destroy_node(chain);
+        chain = next;
+      }
+      throw;
+    }
+    // 各层节点个数 1, 2, 4...，前 k 层全满时最多 2^k - 1 个节点
+    // 中点切分使所有空的子节点位置都位于第 k 或 k + 1 层(k 为 n 的全满层数)：
+    // 第 k 层(由 0 起算)的节点全部为红、其余为黑，每条路径的黑节点数相同，且红节点没有子节点
+    size_type full = 0;
+    while ((size_type(2) << full) - 1 <= n)
+      ++full;
+    link_type first_node = chain;
+    root() = __link_sorted(chain, n, 0, full);
+    parent(root()) = header;
+    color(root()) = __rb_tree_black;
+    leftmost() = first_node;
+    rightmost() = tail;
+    node_count = n;
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::link_type
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__link_sorted(link_type& chain, size_type n,
+                                                                 size_type depth, size_type red_depth)
+  {
+    if (n == 0) return 0;
+    const size_type left_n = (n - 1) / 2; // 左子树不多于右子树
+    link_type l = __link_sorted(chain, left_n, depth + 1, red_depth);
+    link_type x = chain;
+    chain = right(chain);
+    left(x) = l;
+    if (l) parent(l) = x;
+    link_type r = __link_sorted(chain, n - 1 - left_n, depth + 1, red_depth);
+    right(x) = r;
+    if (r) parent(r) = x;
+    color(x) = depth == red_depth ? __rb_tree_red : __rb_tree_black;
+    aug_traits::update(x);
+    return x;
+  }
+
+// 复制以 x 为根的子树，p 为新子树的父节点
+// 沿右子节点递回，沿左子节点迭代，递回深度不超过树高
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::link_type
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__copy(link_type x, link_type p)
+  {
+    link_type top = clone_node(x);
+    top->parent = p;
+    try {
+      if (x->right)
+        top->right = __copy(right(x), top);
+      p = top;
+      x = left(x);
+      while (x != 0) {
+        link_type y = clone_node(x);
+        p->left = y;
+        y->parent = p;
+        if (x->right)
+          y->right = __copy(right(x), y);
+        p = y;
+        x = left(x);
+      }
+    } catch(...) {
+      __erase(top);
+      throw;
+    }
+    return top;
+  }
+
+// 删除以 x 为根的子树，不做平衡
+// 左子节点存在时先右旋，使每个节点在没有左子节点时才被删除：不需递回，也不需额外空间
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__erase(link_type x)
+  {
+    while (x != 0) {
+      link_type y = left(x);
+      if (y != 0) {
+        left(x) = right(y);
+        right(y) = x;
+        x = y;
+      } else {
+        y = right(x);
+        destroy_node(x);
+        x = y;
+      }
+    }
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__destroy_values(link_type x, __false_type)
+  {
+    while (x != 0) {
+      link_type y = left(x);
+      if (y != 0) {
+        left(x) = right(y);
+        right(y) = x;
+        x = y;
+      } else {
+        aug_traits::destroy(x);
+        destroy(&x->value_field);
+        x = right(x);
+      }
+    }
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::size_type
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::erase(const key_type& x)
+  {
+    pair<iterator, iterator> p = equal_range(x);
+    const size_type n = node_count;
+    erase(p.first, p.second);
+    return n - node_count;
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  void rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::erase(iterator first, iterator last)
+  {
+    if (first == begin() && last == end())
+      clear();
+    else
+      while (first != last) erase(first++);
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::find(const key_type& k)
+  {
+    iterator j = lower_bound(k);
+    return (j == end() || key_compare(k, key(j.node))) ? end() : j;
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::const_iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::find(const key_type& k) const
+  {
+    const_iterator j = lower_bound(k);
+    return (j == end() || key_compare(k, key(j.node))) ? end() : j;
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::size_type
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::count(const key_type& k) const
+  {
+    pair<const_iterator, const_iterator> p = equal_range(k);
+    return size_type(tinystl::distance(p.first, p.second));
+  }
+
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::lower_bound(const key_type& k)
+  {
+    link_type y = header; // 最后一个不小于 k 的节点
+    link_type x = root();
+    while (x != 0)
+      if (!key_compare(key(x), k)) {
+        y = x;
+        x = left(x);
+      } else
+        x = right(x);
+    return iterator(y);
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::const_iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::lower_bound(const key_type& k) const
+  {
+    link_type y = header;
+    link_type x = root();
+    while (x != 0)
+      if (!key_compare(key(x), k)) {
+        y = x;
+        x = left(x);
+      } else
+        x = right(x);
+    return const_iterator(y);
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::upper_bound(const key_type& k)
+  {
+    link_type y = header; // 最后一个大于 k 的节点
+    link_type x = root();
+    while (x != 0)
+      if (key_compare(k, key(x))) {
+        y = x;
+        x = left(x);
+      } else
+        x = right(x);
+    return iterator(y);
+  }
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  typename rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::const_iterator
+  rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::upper_bound(const key_type& k) const
+  {
+    link_type y = header;
+    link_type x = root();
+    while (x != 0)
+      if (key_compare(k, key(x))) {
+        y = x;
+        x = left(x);
+      } else
+        x = right(x);
+    return const_iterator(y);
+  }
 
+template <class Key, class Value, class KeyOfValue, class Compare, class Alloc, class Augment>
+  bool rb_tree<Key, Value, KeyOfValue, Compare, Alloc, Augment>::__rb_verify() const
+  {
+    if (node_count == 0 || begin() == end())
+      return node_count == 0 && begin() == end() &&
+             header->left == header && header->right == header;
+    int len = __black_count(leftmost(), root());
+    size_type n = 0;
+    for (const_iterator it = begin(); it != end(); ++it, ++n) {
+      link_type x = (link_type)it.node;
+      link_type l = left(x);
+      link_type r = right(x);
+      if (x->color == __rb_tree_red)
+        if ((l && l->color == __rb_tree_red) || (r && r->color == __rb_tree_red))
+          return false; // 红节点的子节点必须为黑
+      if (l && key_compare(key(x), key(l)))
+        return false;
+      if (r && key_compare(key(r), key(x)))
+        return false;
+      if ((!l || !r) && __black_count(x, root()) != len)
+        return false; // 每条路径的黑节点数必须相同
+    }
+    if (leftmost() != __rb_tree_node_base::minimum(root()))
+      return false;
+    if (rightmost() != __rb_tree_node_base::maximum(root()))
+      return false;
+    return n == node_count;
+  }
+
+} // namespace tinystl
 
+#endif // !TINYSTL_TREE_H_
@@ -167,6 +167,28 @@ template <class T>
     typedef __true_type     is_POD_type;
   };
 
+
+/**
+ * __is_integer
+ * 判断型别是否为整数
+ * 用于区分 container(n, value) 与 container(first, last) 这类同名的成员模板
+ */
+template <class T> struct __is_integer { typedef __false_type integral; };
+
+template <> struct __is_integer<bool> { typedef __true_type integral; };
+template <> struct __is_integer<char> { typedef __true_type integral; };
+template <> struct __is_integer<signed char> { typedef __true_type integral; };
+template <> struct __is_integer<unsigned char> { typedef __true_type integral; };
+template <> struct __is_integer<wchar_t> { typedef __true_type integral; };
+template <> struct __is_integer<short> { typedef __true_type integral; };
+template <> struct __is_integer<unsigned short> { typedef __true_type integral; };
+template <> struct __is_integer<int> { typedef __true_type integral; };
+template <> struct __is_integer<unsigned int> { typedef __true_type integral; };
+template <> struct __is_integer<long> { typedef __true_type integral; };
+template <> struct __is_integer<unsigned long> { typedef __true_type integral; };
+template <> struct __is_integer<long long> { typedef __true_type integral; };
+template <> struct __is_integer<unsigned long long> { typedef __true_type integral; };
+
 } // namespace tinystl
 
 #endif // !TINYSTL_TYPE_TRAITS_H_
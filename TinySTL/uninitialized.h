@@ -25,12 +25,6 @@ namespace tinystl
  * uninitialized_copy(first, last, result)
  * 对 [first, last) 范围内产生复制品到 *result
  */
-// 萃取迭代器的 value type
-template <class InputIterator, class ForwardIterator>
-  inline ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result)
-  {
-    return __uninitialized_copy(first, last, result, value_type(result));
-  }
 // 判断型别是否为 POD 型别
 /* POD 指 Plain Old Data，
  * 即标量型别(scalar types)或传统的C struct型别
@@ -38,14 +32,14 @@ template <class InputIterator, class ForwardIterator>
 template <class InputIterator, class ForwardIterator, class T>
   inline ForwardIterator __uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result, T*)
   {
-    typedef typename __type_traits<T>::is_POS_type is_POD;
+    typedef typename __type_traits<T>::is_POD_type is_POD;
     return __uninitialized_copy_aux(first, last, result, is_POD());
   }
 template <class InputIterator, class ForwardIterator>
   inline ForwardIterator __uninitialized_copy_aux(InputIterator first, InputIterator last, ForwardIterator result,
                                                   __true_type)
   {
-    return copy(first, last, result); // 交由高阶函数执行
+    return tinystl::copy(first, last, result); // 交由高阶函数执行
   }
 template <class InputIterator, class ForwardIterator>
   inline ForwardIterator __uninitialized_copy_aux(InputIterator first, InputIterator last, ForwardIterator result,
@@ -55,12 +49,18 @@ template <class InputIterator, class ForwardIterator>
     try {
       for ( ; first!=last; ++first, ++cur)
         construct(&*cur, *first);
-        return cur;
+      return cur;
     } catch (...) {
-      destroy(result, cur);
+      tinystl::destroy(result, cur);
       throw;
     }
   }
+// 萃取迭代器的 value type
+template <class InputIterator, class ForwardIterator>
+  inline ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator result)
+  {
+    return __uninitialized_copy(first, last, result, value_type(result));
+  }
 // 对 char* 和 wchar_t* 的特化版本
 template <>
   inline char* uninitialized_copy(const char* first, const char* last, char* result)
@@ -80,11 +80,6 @@ template <>
  * uninitialized_fill(first, last, x)
  * 对 [first, last) 范围内产生 x 的复制品
  */
-template <class ForwardIterator, class T>
-  inline void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& x)
-  {
-    __uninitialized_fill(first, last, x, value_type(first));
-  }
 template <class ForwardIterator, class T, class T1>
   inline void __uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& x, T1*)
   {
@@ -95,7 +90,7 @@ template <class ForwardIterator, class T>
   inline void __uninitialized_fill_aux(ForwardIterator first, ForwardIterator last, const T& x,
                                        __true_type)
   {
-    fill(first, last, x)
+    tinystl::fill(first, last, x);
   }
 template <class ForwardIterator, class T>
   inline void __uninitialized_fill_aux(ForwardIterator first, ForwardIterator last, const T& x,
@@ -106,21 +101,21 @@ template <class ForwardIterator, class T>
       for ( ; cur!=last; ++cur)
         construct(&*cur, x);
     } catch (...) {
-      destroy(first, cur);
+      tinystl::destroy(first, cur);
       throw;
     }
   }
+template <class ForwardIterator, class T>
+  inline void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& x)
+  {
+    __uninitialized_fill(first, last, x, value_type(first));
+  }
 
 
 /**
  * uninitialized_fill_n(first, n, x)
  * 对 [first, first+n) 范围内产生 x 的复制品
  */
-template <class ForwardIterator, class Size, class T>
-  inline ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n, const T& x)
-  {
-    return __uninitialized_fill_n(first, n, x, value_type(first));
-  }
 template <class ForwardIterator, class Size, class T, class T1>
   inline ForwardIterator __uninitialized_fill_n(ForwardIterator first, Size n, const T& x, T1*)
   {
@@ -131,7 +126,7 @@ template <class ForwardIterator, class Size, class T>
   inline ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n, const T&x,
                                                     __true_type)
   {
-    return fill_n(first, n, x);
+    return tinystl::fill_n(first, n, x);
   }
 template <class ForwardIterator, class Size, class T>
   inline ForwardIterator __uninitialized_fill_n_aux(ForwardIterator first, Size n, const T& x,
@@ -143,10 +138,15 @@ template <class ForwardIterator, class Size, class T>
         construct(&*cur, x);
       return cur;
     } catch (...) {
-      destroy(first, cur);
+      tinystl::destroy(first, cur);
       throw;
     }
   }
+template <class ForwardIterator, class Size, class T>
+  inline ForwardIterator uninitialized_fill_n(ForwardIterator first, Size n, const T& x)
+  {
+    return __uninitialized_fill_n(first, n, x, value_type(first));
+  }
 
 } // namespace tinystl
 
@@ -0,0 +1,427 @@
+
+/**
+ * unrolled_list
+ * 展开的双向链表(unrolled linked list)：每个节点存放一小段连续的元素，
+ * 缺省约为一条 cache line。走访时每个节点只有一次 cache miss，
+ * 每个元素分摊的指针开销也只有 list 的几分之一。
+ *
+ * 节点已满时插入会将节点分裂为两半；删除后节点与相邻节点合计不超过半满时合并，
+ * 空的节点立即释还。splice 以节点为单位搬移，插入点落在节点中间时先分裂该节点。
+ *
+ * 迭代器为 Bidirectional Iterator，由节点与节点内的索引组成：
+ * insert / erase / splice 只会使涉及的节点(分裂、合并时包括相邻节点)上的迭代器失效，
+ * 其他节点上的迭代器、指针与引用保持有效。
+ */
+#ifndef TINYSTL_UNROLLED_LIST_H_
+#define TINYSTL_UNROLLED_LIST_H_
+
+#include "alloc.h"
+#include "algobase.h"
+#include "iterator.h"
+#include "construct.h"
+#include "uninitialized.h"
+
+namespace tinystl
+{
+
+enum { __UNROLLED_NODE_BYTES = 64 }; // 缺省每个节点的元素空间，一条 cache line
+
+// 决定每个节点可容纳的元素个数
+// 如果 n 不为 0，表示由用户自定义，至少 2 个(分裂后两半都不为空)
+// 如果 n 为 0，取 __UNROLLED_NODE_BYTES / sz，但至少 4 个
+template <size_t n, size_t sz>
+  struct __unrolled_capacity
+  {
+    enum
+    {
+      value = n != 0 ? (n < 2 ? 2 : n) : \
+              sz <= size_t(__UNROLLED_NODE_BYTES) / 4 ? size_t(__UNROLLED_NODE_BYTES) / sz : \
+              4
+    };
+  };
+
+// 节点基本结构，unrolled_list 的 header 只有这一部分，count 恒为 0
+struct __unrolled_node_base
+{
+  __unrolled_node_base* prev;
+  __unrolled_node_base* next;
+  size_t count;
+};
+template <class T, size_t N>
+  struct __unrolled_node : public __unrolled_node_base
+  {
+    alignas(T) char data[sizeof(T) * N];
+
+    T* values() { return reinterpret_cast<T*>(data); }
+  };
+
+
+// unrolled_list 迭代器
+template <class T, class Ref, class Ptr, size_t N>
+  struct __unrolled_iterator
+  {
+    typedef __unrolled_iterator<T, T&, T*, N>               iterator;
+    typedef __unrolled_iterator<T, const T&, const T*, N>   const_iterator;
+    typedef __unrolled_iterator                             self;
+    typedef __unrolled_node<T, N>                           node_type;
+
+    typedef bidirectional_iterator_tag    iterator_category;
+    typedef T                             value_type;
+    typedef Ptr                           pointer;
+    typedef Ref                           reference;
+    typedef ptrdiff_t                     difference_type;
+    typedef size_t                        size_type;
+
+    __unrolled_node_base* node;
+    size_type index; // 节点内的位置
+
+    __unrolled_iterator() : node(0), index(0) { }
+    __unrolled_iterator(__unrolled_node_base* x, size_type i) : node(x), index(i) { }
+    __unrolled_iterator(const iterator& x) : node(x.node), index(x.index) { }
+
+    reference operator*() const { return static_cast<node_type*>(node)->values()[index]; }
+    pointer operator->() const { return &(operator*()); }
+    self& operator++()
+    {
+      if (++index == node->count) {
+        node = node->next;
+        index = 0;
+      }
+      return *this;
+    }
+    self operator++(int)
+    {
+      self tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    self& operator--()
+    {
+      if (index == 0) {
+        node = node->prev;
+        index = node->count;
+      }
+      --index;
+      return *this;
+    }
+    self operator--(int)
+    {
+      self tmp = *this;
+      --*this;
+      return tmp;
+    }
+    bool operator==(const self& x) const { return node == x.node && index == x.index; }
+    bool operator!=(const self& x) const { return !(*this == x); }
+  };
+
+
+template <class T, class Alloc = alloc, size_t NodeSiz = 0>
+  class unrolled_list
+  {
+    public:
+    enum { node_capacity = __unrolled_capacity<NodeSiz, sizeof(T)>::value };
+
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+    typedef __unrolled_iterator<T, T&, T*, node_capacity>               iterator;
+    typedef __unrolled_iterator<T, const T&, const T*, node_capacity>   const_iterator;
+
+    protected:
+    typedef __unrolled_node_base                  node_base;
+    typedef __unrolled_node<T, node_capacity>     node_type;
+    typedef simple_alloc<node_type, Alloc>        node_allocator;
+
+    node_base header; // 环状链表的 header
+    size_type length;
+
+    static T* values(node_base* p) { return static_cast<node_type*>(p)->values(); }
+    // 配置一个空节点，串接于 position 之前
+    node_base* create_node(node_base* position)
+    {
+      node_base* p = node_allocator::allocate();
+      p->count = 0;
+      p->next = position;
+      p->prev = position->prev;
+      position->prev->next = p;
+      position->prev = p;
+      return p;
+    }
+    // 节点必须已经没有元素
+    void destroy_node(node_base* p)
+    {
+      p->prev->next = p->next;
+      p->next->prev = p->prev;
+      node_allocator::deallocate(static_cast<node_type*>(p));
+    }
+    // 将 p 由 i 处一分为二，[i, count) 移至新节点，传回新节点
+    node_base* split_node(node_base* p, size_type i);
+    // 将 p 的后一个节点并入 p
+    void merge_next(node_base* p);
+    // 在节点 p 的位置 i 构造 x，节点必须未满；i 小于 p->count 时 x 不可以是 p 内的元素
+    void insert_in_node(node_base* p, size_type i, const value_type& x);
+    // 删除后，节点过少时与相邻节点合并，传回原位置 (p, i) 的新位置
+    iterator rebalance(node_base* p, size_type i);
+    // 使 position 位于节点开头，必要时分裂节点，传回该节点
+    node_base* split_at(iterator position)
+    {
+      if (position.index == 0) return position.node;
+      return split_node(position.node, position.index);
+    }
+    // 将 [first, last) 的节点移至 position 之前
+    static void transfer(node_base* position, node_base* first, node_base* last)
+    {
+      if (position != last) {
+        last->prev->next = position;
+        first->prev->next = last;
+        position->prev->next = first;
+        node_base* tmp = position->prev;
+        position->prev = last->prev;
+        last->prev = first->prev;
+        first->prev = tmp;
+      }
+    }
+
+    public:
+    unrolled_list() : length(0)
+    {
+      header.prev = header.next = &header;
+      header.count = 0;
+    }
+    unrolled_list(const unrolled_list& x) : length(0)
+    {
+      header.prev = header.next = &header;
+      header.count = 0;
+      try {
+        for (const_iterator i = x.begin(); i != x.end(); ++i)
+          push_back(*i);
+      } catch(...) {
+        clear();
+        throw;
+      }
+    }
+    ~unrolled_list() { clear(); }
+    unrolled_list& operator=(const unrolled_list& x)
+    {
+      if (this != &x) {
+        unrolled_list tmp(x);
+        swap(tmp);
+      }
+      return *this;
+    }
+    void swap(unrolled_list& x)
+    {
+      unrolled_list tmp;
+      tmp.splice(tmp.end(), *this);
+      splice(end(), x);
+      x.splice(x.end(), tmp);
+    }
+
+    iterator begin() { return iterator(header.next, 0); }
+    const_iterator begin() const { return const_iterator(header.next, 0); }
+    iterator end() { return iterator(&header, 0); }
+    const_iterator end() const { return const_iterator(const_cast<node_base*>(&header), 0); }
+    size_type size() const { return length; }
+    bool empty() const { return length == 0; }
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return values(header.prev)[header.prev->count - 1]; }
+    const_reference back() const { return values(header.prev)[header.prev->count - 1]; }
+
+    void push_back(const value_type& x)
+    {
+      node_base* p = header.prev;
+      if (p == &header || p->count == size_type(node_capacity))
+        p = create_node(&header);
+      try {
+        insert_in_node(p, p->count, x);
+      } catch(...) {
+        if (p->count == 0) destroy_node(p);
+        throw;
+      }
+    }
+    void push_front(const value_type& x) { insert(begin(), x); }
+    void pop_back() { erase(--end()); }
+    void pop_front() { erase(begin()); }
+
+    iterator insert(iterator position, const value_type& x);
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last)
+    {
+      size_type n = 0;
+      for (iterator i = first; i != last; ++i) ++n;
+      while (n--) first = erase(first);
+      return first;
+    }
+    void clear();
+
+    // 将 x 接合于 position 之前，x 必须不同于 *this
+    void splice(iterator position, unrolled_list& x)
+    {
+      if (x.empty()) return;
+      node_base* p = split_at(position);
+      length += x.length;
+      x.length = 0;
+      transfer(p, x.header.next, &x.header);
+    }
+    // 将 [first, last) 接合于 position 之前，position 不能位于 [first, last) 之内
+    // 两端与 position 不在节点边界时先分裂节点，其余整个节点搬移
+    void splice(iterator position, unrolled_list& x, iterator first, iterator last);
+  };
+
+template <class T, class Alloc, size_t NodeSiz>
+  typename unrolled_list<T, Alloc, NodeSiz>::node_base*
+  unrolled_list<T, Alloc, NodeSiz>::split_node(node_base* p, size_type i)
+  {
+    node_base* q = create_node(p->next);
+    try {
+      tinystl::uninitialized_copy(values(p) + i, values(p) + p->count, values(q));
+    } catch(...) {
+      destroy_node(q);
+      throw;
+    }
+    tinystl::destroy(values(p) + i, values(p) + p->count);
+    q->count = p->count - i;
+    p->count = i;
+    return q;
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  void unrolled_list<T, Alloc, NodeSiz>::merge_next(node_base* p)
+  {
+    node_base* q = p->next;
+    tinystl::uninitialized_copy(values(q), values(q) + q->count, values(p) + p->count);
+    tinystl::destroy(values(q), values(q) + q->count);
+    p->count += q->count;
+    q->count = 0;
+    destroy_node(q);
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  void unrolled_list<T, Alloc, NodeSiz>::insert_in_node(node_base* p, size_type i, const value_type& x)
+  {
+    T* v = values(p);
+    if (i == p->count)
+      construct(v + i, x);
+    else { // x 不可以是 p 内的元素，由调用端保证
+      construct(v + p->count, v[p->count - 1]);
+      tinystl::copy_backward(v + i, v + p->count - 1, v + p->count);
+      v[i] = x;
+    }
+    ++p->count;
+    ++length;
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  typename unrolled_list<T, Alloc, NodeSiz>::iterator
+  unrolled_list<T, Alloc, NodeSiz>::insert(iterator position, const value_type& x)
+  {
+    // x 可能就是容器内的元素，split_node() 会析构移出的元素，插入时元素也会移动
+    value_type x_copy = x;
+    node_base* p = position.node;
+    size_type i = position.index;
+    // 插入点在节点开头时，可以放在前一个节点的尾端
+    if (i == 0 && p->prev != &header && p->prev->count < size_type(node_capacity)) {
+      p = p->prev;
+      i = p->count;
+    } else if (p == &header) {
+      p = create_node(&header);
+    } else if (p->count == size_type(node_capacity)) {
+      node_base* q = split_node(p, node_capacity / 2);
+      if (i > p->count) {
+        i -= p->count;
+        p = q;
+      }
+    }
+    try {
+      insert_in_node(p, i, x_copy);
+    } catch(...) {
+      if (p->count == 0) destroy_node(p);
+      throw;
+    }
+    return iterator(p, i);
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  typename unrolled_list<T, Alloc, NodeSiz>::iterator
+  unrolled_list<T, Alloc, NodeSiz>::rebalance(node_base* p, size_type i)
+  {
+    const size_type half = node_capacity / 2;
+    if (p->count == 0) {
+      node_base* next = p->next;
+      destroy_node(p);
+      return iterator(next, 0);
+    }
+    if (p->next != &header && p->count + p->next->count <= half)
+      merge_next(p);
+    if (p->prev != &header && p->prev->count + p->count <= half) {
+      node_base* prev = p->prev;
+      i += prev->count;
+      merge_next(prev);
+      p = prev;
+    }
+    if (i == p->count) return iterator(p->next, 0);
+    return iterator(p, i);
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  typename unrolled_list<T, Alloc, NodeSiz>::iterator
+  unrolled_list<T, Alloc, NodeSiz>::erase(iterator position)
+  {
+    node_base* p = position.node;
+    const size_type i = position.index;
+    T* v = values(p);
+    tinystl::copy(v + i + 1, v + p->count, v + i);
+    tinystl::destroy(v + p->count - 1);
+    --p->count;
+    --length;
+    return rebalance(p, i);
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  void unrolled_list<T, Alloc, NodeSiz>::clear()
+  {
+    node_base* p = header.next;
+    while (p != &header) {
+      node_base* next = p->next;
+      tinystl::destroy(values(p), values(p) + p->count);
+      node_allocator::deallocate(static_cast<node_type*>(p));
+      p = next;
+    }
+    header.prev = header.next = &header;
+    length = 0;
+  }
+
+template <class T, class Alloc, size_t NodeSiz>
+  void unrolled_list<T, Alloc, NodeSiz>::splice(iterator position, unrolled_list& x,
+                                                iterator first, iterator last)
+  {
+    if (first == last) return;
+    // 先分裂 last，再分裂 first：first 的分裂不会改变 last 所在的节点
+    // position 可能与 first / last 位于同一个节点，分裂后重新定位
+    const bool pos_at_last = position.node == last.node && position.index >= last.index;
+    node_base* end_node = split_at(last);
+    if (pos_at_last)
+      position = iterator(end_node, position.index - last.index);
+    const bool pos_at_first = position.node == first.node && position.index >= first.index;
+    node_base* begin_node = split_at(first);
+    if (pos_at_first)
+      position = iterator(begin_node, position.index - first.index);
+    node_base* p = split_at(position);
+    if (&x != this) {
+      size_type n = 0;
+      for (node_base* q = begin_node; q != end_node; q = q->next)
+        n += q->count;
+      x.length -= n;
+      length += n;
+    }
+    transfer(p, begin_node, end_node);
+  }
+
+} // namespace tinystl
+
+#endif // !TINYSTL_UNROLLED_LIST_H_
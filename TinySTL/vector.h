@@ -3,6 +3,7 @@
 
 #include "alloc.h"
 #include "algobase.h"
+#include "iterator.h"
 #include "construct.h"
 #include "type_traits.h"
 #include "uninitialized.h"
@@ -10,184 +11,544 @@
 namespace tinystl
 {
 
-template <class T, class Alloc = alloc>
-  class vector
+/**
+ * 扩充策略(growth policy)
+ * new_capacity(old_size, n, sz) 传回新增 n 个元素后应配置的容量，不小于 old_size + n
+ * round_capacity(n, sz) 将容量调整为配置器实际会交付的大小，供 reserve() 使用
+ * sz 为元素大小 sizeof(T)
+ */
+// 原书的配置原则：至少扩充为原大小的 2 倍
+struct vector_growth_2x
+{
+  static size_t new_capacity(size_t old_size, size_t n, size_t /* sz */)
+  {
+    return old_size + max(old_size, n);
+  }
+  static size_t round_capacity(size_t n, size_t /* sz */) { return n; }
+};
+// 1.5 倍，多次扩充后释放的旧空间之和有机会被再次利用，空闲空间也较少
+struct vector_growth_1_5x
+{
+  static size_t new_capacity(size_t old_size, size_t n, size_t /* sz */)
+  {
+    return old_size + max(old_size / 2, n);
+  }
+  static size_t round_capacity(size_t n, size_t /* sz */) { return n; }
+};
+// 依配置器的区块大小上调容量
+// 例如第二级配置器会将 20 bytes 的需求上调至 24 bytes，多出的部分直接作为容量使用
+template <class Alloc, class Growth = vector_growth_2x>
+  struct vector_growth_size_class
+  {
+    static size_t new_capacity(size_t old_size, size_t n, size_t sz)
+    {
+      return round_capacity(Growth::new_capacity(old_size, n, sz), sz);
+    }
+    static size_t round_capacity(size_t n, size_t sz)
+    {
+      return 0 == n ? \
+             0 : \
+             Alloc::usable_size(n * sz) / sz;
+    }
+  };
+
+
+/**
+ * 空间来源(storage)
+ * allocate_storage(n) 配置至少 n 个元素的空间，n 传回实际可用的个数
+ * deallocate_storage(p, n) 释还 allocate_storage() 取得的空间
+ * vector 的空间全部来自配置器；small_vector 的前 N 个元素另有内部缓冲区。
+ */
+template <class T, class Alloc>
+  class __vector_heap_storage
+  {
+    protected:
+    typedef simple_alloc<T, Alloc> data_allocator;
+
+    T* allocate_storage(size_t& n) { return data_allocator::allocate(n); }
+    void deallocate_storage(T* p, size_t n)
+    {
+      if (p)
+      data_allocator::deallocate(p, n);
+    }
+  };
+
+/**
+ * vector 与 small_vector 共用的实作
+ * 元素的插入、搬移与扩充都在这里完成，空间从何而来交由 Storage 决定，
+ * 容器本身只负责构造函数、复制与交换。
+ */
+template <class T, class Storage, class Growth>
+  class __vector_base : protected Storage
   {
     public:
     // 型别定义
-    typedef T               value_type;
-    typedef value_type*     pointer;
-    typedef value_type*     iterator; // Random Access Iterator
-    typedef value_type&     reference;
-    typedef size_t          size_type;
-    typedef ptrdiff_t       difference_type;
+    typedef T                     value_type;
+    typedef value_type*           pointer;
+    typedef value_type*           iterator; // Random Access Iterator
+    typedef const value_type*     const_iterator;
+    typedef value_type&           reference;
+    typedef const value_type&     const_reference;
+    typedef size_t                size_type;
+    typedef ptrdiff_t             difference_type;
 
     protected:
-    typedef simple_alloc<value_type, Alloc> data_allocator;
     iterator start;          // 目前使用空间的头
     iterator finish;         // 目前使用空间的尾
     iterator end_of_storage; // 目前可用空间的尾
 
     void insert_aux(iterator position, const T& x);
+    // 配置 len 个元素的空间，并将原有元素搬移过去
+    void reallocate(size_type len);
     void deallocate()
     {
-      if (start)
-      data_allocator::deallocate(start, end_of_storage - start);
+      this->deallocate_storage(start, end_of_storage - start);
+    }
+    // 析构原有元素、释还原有空间，改用 [new_start, new_start + len)
+    void replace_storage(iterator new_start, iterator new_finish, size_type len)
+    {
+      tinystl::destroy(start, finish);
+      deallocate();
+      start = new_start;
+      finish = new_finish;
+      end_of_storage = new_start + len;
+    }
+    // 空间中尚无元素时，换成至少能容纳 n 个元素的空间
+    void storage_initialize(size_type n)
+    {
+      if (n > capacity()) {
+        deallocate();
+        start = finish = this->allocate_storage(n);
+        end_of_storage = start + n;
+      }
     }
     void fill_initialize(size_type n, const T& value)
     { // 填充并初始化
-      start = allocate_and_fill(n, value);
-      finish = start + n;
-      end_of_storage = finish;
+      storage_initialize(n);
+      finish = tinystl::uninitialized_fill_n(start, n, value);
+    }
+    // 区间初始化，整数型别视为 (n, value)
+    template <class Integer>
+      void initialize_aux(Integer n, Integer value, __true_type)
+      { fill_initialize(n, value); }
+    template <class InputIterator>
+      void initialize_aux(InputIterator first, InputIterator last, __false_type)
+      { range_initialize(first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void range_initialize(InputIterator first, InputIterator last, input_iterator_tag)
+      {
+        for ( ; first != last; ++first)
+          push_back(*first);
+      }
+    // 可事先得知元素个数，只配置一次
+    template <class ForwardIterator>
+      void range_initialize(ForwardIterator first, ForwardIterator last, forward_iterator_tag)
+      {
+        storage_initialize(size_type(tinystl::distance(first, last)));
+        finish = tinystl::uninitialized_copy(first, last, start);
+      }
+
+    // 构造过程中抛出异常时，由析构函数清除已构造的元素
+    __vector_base()
+    { // 初始的空间：vector 为空指针，small_vector 为内部缓冲区
+      size_type n = 0;
+      start = finish = this->allocate_storage(n);
+      end_of_storage = start + n;
+    }
+    ~__vector_base()
+    {
+      tinystl::destroy(start, finish);
+      deallocate();
     }
 
     public:
     // 利用迭代器能简单完成的工作
     iterator begin() { return start; }
+    const_iterator begin() const { return start; }
     iterator end() { return finish; }
+    const_iterator end() const { return finish; }
     size_type size() const { return size_type(end() - begin()); }
-    size_type capacity() const { return size_type(end_of_storage() - begin()); }
+    size_type capacity() const { return size_type(end_of_storage - begin()); }
     bool empty() const { return begin() == end(); }
     reference operator[](size_type n) { return *(begin() + n); }
+    const_reference operator[](size_type n) const { return *(begin() + n); }
 
-    // 构造函数
-    vector() : start(0), finish(0), end_of_storage(0) { }
-    vector(size_type n, const T& value) { fill_initialize(n, value); }
-    vector(int n, const T& value) { fill_initialize(n, value); }
-    vector(long n, const T& value) { fill_initialize(n, value); }
-    explicit vector(size_type n) { fill_initialize(n, T()); }
-    // 析构函数
-    ~vector()
-    {
-      destroy(start, finish);
-      deallocate();
+    // 容量管理
+    // 预先配置至少 n 个元素的空间，n 不大于 capacity() 时什么也不做
+    void reserve(size_type n)
+    {
+      if (capacity() < n)
+        reallocate(Growth::round_capacity(n, sizeof(T)));
     }
+    // 释还多余的空间
+    void shrink_to_fit()
+    {
+      if (capacity() > size()) {
+        size_type len = Growth::round_capacity(size(), sizeof(T));
+        if (len < capacity()) reallocate(len);
+      }
+    }
+
+    // 以 n 个 x 取代原有内容
+    void assign(size_type n, const T& x);
+    // 以 [first, last) 取代原有内容
+    template <class InputIterator>
+      void assign(InputIterator first, InputIterator last)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        assign_dispatch(first, last, integral());
+      }
 
     // 元素操作
     reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
     reference back() { return *(end() - 1); }
+    const_reference back() const { return *(end() - 1); }
     void push_back(const T& x)
     {
       if (finish != end_of_storage) {
         construct(finish, x);
-        ++finish();
+        ++finish;
       } else // 无备用空间
         insert_aux(end(), x);
     }
     void pop_back()
     {
       --finish;
-      destroy(finish);
+      tinystl::destroy(finish);
     }
     iterator erase(iterator first, iterator last)
     {
-      iterator i = copy(last, finish, first);
-      destroy(i, finish);
+      iterator i = tinystl::copy(last, finish, first);
+      tinystl::destroy(i, finish);
       finish = finish - (last - first);
       return first;
     }
     iterator erase(iterator position)
     {
       if (position + 1 != end())
-        copy(position + 1, finish, position);
+        tinystl::copy(position + 1, finish, position);
       --finish;
-      destroy(finish);
+      tinystl::destroy(finish);
       return position;
     }
+    iterator insert(iterator position, const T& x)
+    {
+      size_type n = position - begin();
+      if (finish != end_of_storage && position == end()) {
+        construct(finish, x);
+        ++finish;
+      } else
+        insert_aux(position, x);
+      return begin() + n;
+    }
+    void insert(iterator position, size_type n, const T& x);
+    // 将 [first, last) 插入 position 之前
+    // Forward Iterator 以上事先计算个数，最多只配置一次
+    template <class InputIterator>
+      void insert(iterator position, InputIterator first, InputIterator last)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        insert_dispatch(position, first, last, integral());
+      }
+    // 将 [first, last) 或整个区间接于尾端
+    template <class InputIterator>
+      void append_range(InputIterator first, InputIterator last) { insert(end(), first, last); }
+    template <class Range>
+      void append_range(Range& r) { insert(end(), r.begin(), r.end()); }
+    template <class Range>
+      void append_range(const Range& r) { insert(end(), r.begin(), r.end()); }
+    void resize(size_type new_size, const T& x)
+    {
+      if (new_size < size())
+        erase(begin() + new_size, end());
+      else
+        insert(end(), new_size - size(), x);
+    }
     void resize(size_type new_size) { resize(new_size, T()); }
     void clear() { erase(begin(), end()); }
 
     protected:
-    iterator allocate_and_fill(size_type n, const T& x)
-    { // 配置后填充
-      iterator result = data_allocate::allocate(n);
-      uninitialized_fill_n(result, n, x);
+    iterator allocate_and_fill(size_type& n, const T& x)
+    { // 配置后填充，n 传回实际配置的个数
+      size_type len = n;
+      iterator result = this->allocate_storage(n);
+      try {
+        tinystl::uninitialized_fill_n(result, len, x);
+      } catch(...) {
+        this->deallocate_storage(result, n);
+        throw;
+      }
       return result;
     }
+    template <class ForwardIterator>
+      iterator allocate_and_copy(size_type& n, ForwardIterator first, ForwardIterator last)
+      { // 配置后复制，n 传回实际配置的个数
+        iterator result = this->allocate_storage(n);
+        try {
+          tinystl::uninitialized_copy(first, last, result);
+        } catch(...) {
+          this->deallocate_storage(result, n);
+          throw;
+        }
+        return result;
+      }
+
+    template <class Integer>
+      void assign_dispatch(Integer n, Integer value, __true_type)
+      { assign(size_type(n), T(value)); }
+    template <class InputIterator>
+      void assign_dispatch(InputIterator first, InputIterator last, __false_type)
+      { range_assign(first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void range_assign(InputIterator first, InputIterator last, input_iterator_tag);
+    template <class ForwardIterator>
+      void range_assign(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+
+    template <class Integer>
+      void insert_dispatch(iterator position, Integer n, Integer value, __true_type)
+      { insert(position, size_type(n), T(value)); }
+    template <class InputIterator>
+      void insert_dispatch(iterator position, InputIterator first, InputIterator last, __false_type)
+      { range_insert(position, first, last, iterator_category(first)); }
+    template <class InputIterator>
+      void range_insert(iterator position, InputIterator first, InputIterator last, input_iterator_tag);
+    template <class ForwardIterator>
+      void range_insert(iterator position, ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+
+    private:
+    // 复制与交换由容器自行定义
+    __vector_base(const __vector_base&);
+    __vector_base& operator=(const __vector_base&);
+  };
+
+template <class T, class Alloc = alloc, class Growth = vector_growth_2x>
+  class vector : public __vector_base<T, __vector_heap_storage<T, Alloc>, Growth>
+  {
+    typedef __vector_base<T, __vector_heap_storage<T, Alloc>, Growth> base;
 
     public:
-    void insert(iterator position, size_type n, const T& x);
+    typedef typename base::size_type size_type;
+    typedef typename base::iterator  iterator;
+
+    // 构造函数
+    vector() { }
+    vector(size_type n, const T& value) { this->fill_initialize(n, value); }
+    vector(int n, const T& value) { this->fill_initialize(n, value); }
+    vector(long n, const T& value) { this->fill_initialize(n, value); }
+    explicit vector(size_type n) { this->fill_initialize(n, T()); }
+    vector(const vector& x) { this->range_initialize(x.begin(), x.end(), random_access_iterator_tag()); }
+    // 以区间 [first, last) 初始化
+    template <class InputIterator>
+      vector(InputIterator first, InputIterator last)
+      {
+        typedef typename __is_integer<InputIterator>::integral integral;
+        this->initialize_aux(first, last, integral());
+      }
+
+    vector& operator=(const vector& x)
+    {
+      if (this != &x) this->assign(x.begin(), x.end());
+      return *this;
+    }
+    void swap(vector& x)
+    {
+      iterator tmp = this->start; this->start = x.start; x.start = tmp;
+      tmp = this->finish; this->finish = x.finish; x.finish = tmp;
+      tmp = this->end_of_storage; this->end_of_storage = x.end_of_storage; x.end_of_storage = tmp;
+    }
   };
 
-template <class T, class Alloc>
-  void vector<T, Alloc>::insert_aux(iterator position, const T& x)
+template <class T, class Storage, class Growth>
+  void __vector_base<T, Storage, Growth>::insert_aux(iterator position, const T& x)
   {
     if (finish != end_of_storage) {
       construct(finish, *(finish - 1));
       ++finish;
       T x_copy = x;
-      copy_backward(position, finish - 2, finish - 1);
+      tinystl::copy_backward(position, finish - 2, finish - 1);
       *position = x_copy;
     } else {
-      // 配置大小原则
+      // 配置大小原则交由 Growth 决定
       const size_type old_size = size();
-      const size_type len = old_size != 0 ? \
-                            2 * old_size : \
-                            1;
-      iterator new_start = data_allocator::allocate(len);
+      size_type len = Growth::new_capacity(old_size, 1, sizeof(T));
+      iterator new_start = this->allocate_storage(len);
       iterator new_finish = new_start;
       try { // 将原 vector 的内容拷贝到新 vector
-        new_finish = uninitialized_copy(start, position, new_start);
+        new_finish = tinystl::uninitialized_copy(start, position, new_start);
         construct(new_finish, x); // 新元素
         ++new_finish;
         // 将原 vector 的备用空间中的内容拷贝过来
         // 这里原书也表示不知道为啥这么做
-        new_finish = uninitialized_copy(position, finish, new_finish);
+        new_finish = tinystl::uninitialized_copy(position, finish, new_finish);
       } catch(...) {
-        destroy(new_start, new_finish);
-        data_allocator::deallocate(new_start, len);
+        tinystl::destroy(new_start, new_finish);
+        this->deallocate_storage(new_start, len);
         throw;
       }
-      // 析构并释放原 vector
-      destroy(begin(), end());
-      deallocate();
-      // 调整迭代器，指向新 vector
-      start = new_start;
-      finish = new_finish;
-      end_of_storage = new_start + len;
+      // 析构并释放原 vector，调整迭代器，指向新 vector
+      replace_storage(new_start, new_finish, len);
     }
   }
 
-template <class T, class Alloc>
-  void vector<T, Alloc>::insert(iterator position, size_type n, const T& x)
+template <class T, class Storage, class Growth>
+  void __vector_base<T, Storage, Growth>::reallocate(size_type len)
+  {
+    iterator new_start = this->allocate_storage(len);
+    // Storage 交回目前的空间(例如 small_vector 的内部缓冲区)时无须搬移
+    if (new_start == start) return;
+    iterator new_finish = new_start;
+    try {
+      new_finish = tinystl::uninitialized_copy(start, finish, new_start);
+    } catch(...) {
+      this->deallocate_storage(new_start, len);
+      throw;
+    }
+    replace_storage(new_start, new_finish, len);
+  }
+
+template <class T, class Storage, class Growth>
+  void __vector_base<T, Storage, Growth>::insert(iterator position, size_type n, const T& x)
   {
     if (n != 0) {
       if (size_type(end_of_storage - finish) >= n) { //备用空间足够容纳新元素
         T x_copy = x;
         const size_type elems_after = finish - position;
         iterator old_finish = finish;
-        if (emems_after > n) { //插入点后元素个数大于新增元素个数
-          uninitialized_copy(finish - n, finish, finish);
+        if (elems_after > n) { //插入点后元素个数大于新增元素个数
+          tinystl::uninitialized_copy(finish - n, finish, finish);
           finish += n;
-          copy_backward(position, old_finish - n, old_finish);
-          fill(position, position + n, x_copy);
+          tinystl::copy_backward(position, old_finish - n, old_finish);
+          tinystl::fill(position, position + n, x_copy);
         } else { // 插入点后元素个数小于新增元素个数
-          uninitialized_fill_n(finish, n - elems_after, x_copy);
+          tinystl::uninitialized_fill_n(finish, n - elems_after, x_copy);
           finish += n - elems_after;
-          uninitialized_copy(position, old_finish, finish);
+          tinystl::uninitialized_copy(position, old_finish, finish);
           finish += elems_after;
-          fill(position, old_finish, x_copy);
+          tinystl::fill(position, old_finish, x_copy);
         }
       } else { // 备用空间无法容纳新元素，需配置内存
         const size_type old_size = size();
-        const size_type len = old_size + max(old_size, n);
-        iterator new_start = data_allocator::allocate(len);
+        size_type len = Growth::new_capacity(old_size, n, sizeof(T));
+        iterator new_start = this->allocate_storage(len);
         iterator new_finish = new_start;
         try {
-          new_finish = uninitialized_copy(start, position, new_start);
-          new_finish = uninitialized_fill_n(new_finish, n, x);
-          new_finish = uninitialized_copy(position, finish, new_finish);
+          new_finish = tinystl::uninitialized_copy(start, position, new_start);
+          new_finish = tinystl::uninitialized_fill_n(new_finish, n, x);
+          new_finish = tinystl::uninitialized_copy(position, finish, new_finish);
         } catch(...) {
-          destroy(new_start, new_finish);
-          data_allocator::deallocate(new_start, len);
+          tinystl::destroy(new_start, new_finish);
+          this->deallocate_storage(new_start, len);
           throw;
         }
         // 清除旧的 vector，并调整迭代器
-        dastroy(start, finish);
-        deallocate();
-        start = new_start;
-        finish = new_finish;
-        end_of_storage = new_start + len;
+        replace_storage(new_start, new_finish, len);
+      }
+    }
+  }
+
+template <class T, class Storage, class Growth>
+  void __vector_base<T, Storage, Growth>::assign(size_type n, const T& x)
+  {
+    if (n > capacity()) { // 先配置并填充，x 可以是容器内的元素
+      size_type len = n;
+      iterator new_start = allocate_and_fill(len, x);
+      replace_storage(new_start, new_start + n, len);
+    } else if (n > size()) {
+      tinystl::fill(begin(), end(), x);
+      finish = tinystl::uninitialized_fill_n(finish, n - size(), x);
+    } else
+      erase(tinystl::fill_n(begin(), n, x), end());
+  }
+
+template <class T, class Storage, class Growth>
+  template <class InputIterator>
+  void __vector_base<T, Storage, Growth>::range_assign(InputIterator first, InputIterator last,
+                                                       input_iterator_tag)
+  {
+    iterator cur = begin();
+    for ( ; first != last && cur != end(); ++cur, ++first)
+      *cur = *first;
+    if (first == last)
+      erase(cur, end());
+    else
+      range_insert(end(), first, last, input_iterator_tag());
+  }
+
+template <class T, class Storage, class Growth>
+  template <class ForwardIterator>
+  void __vector_base<T, Storage, Growth>::range_assign(ForwardIterator first, ForwardIterator last,
+                                                       forward_iterator_tag)
+  {
+    size_type n = size_type(tinystl::distance(first, last));
+    if (n > capacity()) { // 空间不足，配置一次后整体复制
+      size_type len = n;
+      iterator new_start = allocate_and_copy(len, first, last);
+      replace_storage(new_start, new_start + n, len);
+    } else if (size() >= n) {
+      iterator new_finish = tinystl::copy(first, last, start);
+      tinystl::destroy(new_finish, finish);
+      finish = new_finish;
+    } else {
+      ForwardIterator mid = first;
+      tinystl::advance(mid, size());
+      tinystl::copy(first, mid, start);
+      finish = tinystl::uninitialized_copy(mid, last, finish);
+    }
+  }
+
+// 无法事先得知元素个数，逐一插入
+template <class T, class Storage, class Growth>
+  template <class InputIterator>
+  void __vector_base<T, Storage, Growth>::range_insert(iterator position, InputIterator first, InputIterator last,
+                                                       input_iterator_tag)
+  {
+    for ( ; first != last; ++first) {
+      position = insert(position, *first);
+      ++position;
+    }
+  }
+
+// 与 insert(position, n, x) 相同的做法，只是填充值换成区间
+template <class T, class Storage, class Growth>
+  template <class ForwardIterator>
+  void __vector_base<T, Storage, Growth>::range_insert(iterator position, ForwardIterator first, ForwardIterator last,
+                                                       forward_iterator_tag)
+  {
+    if (first != last) {
+      const size_type n = size_type(tinystl::distance(first, last));
+      if (size_type(end_of_storage - finish) >= n) { // 备用空间足够容纳新元素
+        const size_type elems_after = finish - position;
+        iterator old_finish = finish;
+        if (elems_after > n) {
+          tinystl::uninitialized_copy(finish - n, finish, finish);
+          finish += n;
+          tinystl::copy_backward(position, old_finish - n, old_finish);
+          tinystl::copy(first, last, position);
+        } else {
+          ForwardIterator mid = first;
+          tinystl::advance(mid, elems_after);
+          tinystl::uninitialized_copy(mid, last, finish);
+          finish += n - elems_after;
+          tinystl::uninitialized_copy(position, old_finish, finish);
+          finish += elems_after;
+          tinystl::copy(first, mid, position);
+        }
+      } else { // 备用空间不足，只配置一次
+        const size_type old_size = size();
+        size_type len = Growth::new_capacity(old_size, n, sizeof(T));
+        iterator new_start = this->allocate_storage(len);
+        iterator new_finish = new_start;
+        try {
+          new_finish = tinystl::uninitialized_copy(start, position, new_start);
+          new_finish = tinystl::uninitialized_copy(first, last, new_finish);
+          new_finish = tinystl::uninitialized_copy(position, finish, new_finish);
+        } catch(...) {
+          tinystl::destroy(new_start, new_finish);
+          this->deallocate_storage(new_start, len);
+          throw;
+        }
+        replace_storage(new_start, new_finish, len);
       }
     }
   }
@@ -195,4 +556,3 @@ template <class T, class Alloc>
 } // namespace tinystl
 
 #endif // !TINYSTL_VECTOR_H_
-